@@ -29,20 +29,34 @@ float gPhase2 = 0;
 
 int counter = 0;
 
+// analog IO may run at a different rate to audio
+// (8 channels: half, 4 channels: same, 2 channels: double)
+unsigned int gAnalogFrames = 0;
+unsigned int gAudioFrames = 1;
+
 Scope scope;
 
 bool setup(BelaContext *context, void *userData)
 {
 	// tell the scope how many channels and the sample rate
 	scope.setup(4, context->audioSampleRate);
+
+	// analog pins 0 and 4 need 8 analog channels
+	if(context->analogInChannels <= 4) {
+		rt_printf("Error: this project needs 8 analog input channels\n");
+		return false;
+	}
+	gAnalogFrames = context->analogFrames;
+	gAudioFrames = context->audioFrames;
 	return true;
 }
 
 void render(BelaContext *context, void *userData)
 {
 	for(unsigned int n = 0; n < context->audioFrames; n++) {
-		float phaseReading = analogRead(context, n/2, 0);
-		float gainReading = analogRead(context, n/2, 4);
+		unsigned int m = n * gAnalogFrames / gAudioFrames;
+		float phaseReading = analogRead(context, m, 0);
+		float gainReading = analogRead(context, m, 4);
 		
 		float f1 = map(phaseReading, gMinPhase, gMaxPhase, 50, 55);
 		f1 = constrain(f1, 50.0, 55.0);
@@ -29,8 +29,8 @@ Settings->Make Parameters: CPPFLAGS="-DMODE=1"
 // 4 channels takes 40MB/min, 1GB/25mins
 // 2 channels takes 20MB/min, 1GB/50mins
 //
-// 6 channels adds 10-15% to CPU load with default block size
-// this overhead reduces with larger block sizes
+// the audio thread only copies each frame into a lock-free ring buffer,
+// the file is written by a non-realtime task
 
 // uncomment the next line to enable recording
 // #define RECORD 1
@@ -118,6 +118,7 @@ Settings->Make Parameters: CPPFLAGS="-DMODE=1"
 // additional dependencies of this composition
 
 #include <complex>
+#include <libraries/REBUS/dsp_simd.h>
 
 //---------------------------------------------------------------------
 // composition name
@@ -170,7 +171,7 @@ void COMPOSITION_render(BelaContext *context, COMPOSITION *C, int n,
 	// low magnitude gives rapid decay time (high frequency retrigger)
 	// high magnitude gives extended decay time (low frequency retrigger)
 	float gain = constrain(magnitude, 0.0f, 1.0f);
-	float m = expf(map(gain, 0.0f, 1.0f, logf(0.99f), logf(0.999999f)));
+	float m = exp1(map(gain, 0.0f, 1.0f, logf(0.99f), logf(0.999999f)));
 
 	// map the phase linearly
 	// low phase gives low oscillator frequency
@@ -178,7 +179,9 @@ void COMPOSITION_render(BelaContext *context, COMPOSITION *C, int n,
 	float f = 0.25f * phase;
 
 	// combine them into the complex oscillator multiplier
-	C->increment = double(m) * std::complex<double>(cosf(f), sinf(f));
+	float s, c;
+	sincos1(s, c, f);
+	C->increment = double(m) * std::complex<double>(c, s);
 
 	// rms (root mean square) envelope follower
 	// this is a simple low pass filter
@@ -199,8 +202,8 @@ void COMPOSITION_render(BelaContext *context, COMPOSITION *C, int n,
 	C->oscillator *= C->increment;
 
 	// output with soft clipping
-	out[0] = tanhf(C->oscillator.real());
-	out[1] = tanhf(C->oscillator.imag());
+	out[0] = fasttanh(C->oscillator.real());
+	out[1] = fasttanh(C->oscillator.imag());
 
 }
 
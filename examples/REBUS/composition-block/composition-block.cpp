@@ -0,0 +1,262 @@
+//---------------------------------------------------------------------
+/*
+
+REBUS - Electromagnetic Interactions
+
+https://xname.cc/rebus
+
+composition-block example
+based on the composition-api example, converted 2026-10-16
+
+A complex oscillator is retriggered
+when its volume decays below a threshold.
+Magnitude controls decay.
+Phase controls pitch.
+
+This is the same composition as composition-api,
+using the block rendering API:
+COMPOSITION_renderBlock is called once per audio block
+instead of COMPOSITION_render being called once per frame.
+
+For use on REBUS, nothing needs changing.
+
+For use on Bela with floating wires in analog inputs
+(for development/testing purposes):
+Settings->Make Parameters: CPPFLAGS="-DMODE=1"
+
+*/
+
+//---------------------------------------------------------------------
+
+// recordings of control, output, and input signals
+//
+// 6 channels takes 60MB/min, 1GB/16mins
+// 4 channels takes 40MB/min, 1GB/25mins
+// 2 channels takes 20MB/min, 1GB/50mins
+//
+// the audio thread only copies each frame into a lock-free ring buffer,
+// the file is written by a non-realtime task
+
+// uncomment the next line to enable recording
+// #define RECORD 1
+
+// uncomment the next line to disable recording and hide messages
+// #define RECORD 0
+
+// the channels can be customized
+
+// uncomment the next line to record only control signals
+// #define RECORD_CHANNELS 2
+
+// alternatively, uncomment the next three lines to record only output audio
+// #define RECORD_CHANNELS 2
+// #define RECORD_CHANNEL_1 OUT_LEFT
+// #define RECORD_CHANNEL_2 OUT_RIGHT
+
+// the available channel constants are
+// GAIN PHASE OUT_LEFT OUT_RIGHT IN_LEFT IN_RIGHT
+
+//---------------------------------------------------------------------
+
+// oscilloscope shows the control, output, and optionally input signals
+
+// uncomment the next line to disable oscilloscope
+// #define SCOPE 0
+
+// uncomment the next line to enable oscilloscope and hide messages
+// #define SCOPE 1
+
+// the channels can be customized
+
+// uncomment the next line to scope input too
+// #define SCOPE_CHANNELS 6
+
+// alternatively, uncomment the next line to scope only control signals
+// #define SCOPE_CHANNELS 2
+
+// alternatively, uncomment the next three lines to scope only input audio
+// #define SCOPE_CHANNELS 2
+// #define SCOPE_CHANNEL_1 IN_LEFT
+// #define SCOPE_CHANNEL_2 IN_RIGHT
+
+// the available channel constants are
+// GAIN PHASE OUT_LEFT OUT_RIGHT IN_LEFT IN_RIGHT
+
+//---------------------------------------------------------------------
+
+// a notch filter can be applied to control signals to remove mains hum
+// not useful with REBUS mode (default disabled)
+// often useful with floating wires in PINS mode (default enabled)
+
+// uncomment the next line to enable the notch filter for REBUS mode
+// #define CONTROL_NOTCH 1
+
+// uncomment the next line to disable the notch filter for PINS mode
+// #define CONTROL_NOTCH 0
+
+// uncomment and vary the next line to change the notch filter frequency
+// #define MAINS_HUM_FREQUENCY 50
+
+// uncomment and vary the next line to change notch filter Q factor
+// #define MAINS_HUM_QFACTOR 3
+
+//---------------------------------------------------------------------
+
+// a low pass filter can be applied to control signals to remove noise
+// sometimes useful with REBUS mode (default disabled)
+// often useful with PINS mode (default enabled)
+
+// uncomment the next line to enable the low pass filter for REBUS mode
+// #define CONTROL_LOP 1
+
+// uncomment the next line to disable the low pass filter for PINS mode
+// #define CONTROL_LOP 0
+
+//---------------------------------------------------------------------
+
+// The REBUS composition API abstracts some of the repetitive code
+// that would otherwise be duplicated across compositions.
+
+#include <libraries/REBUS/REBUS.h>
+
+//---------------------------------------------------------------------
+// additional dependencies of this composition
+
+#include <complex>
+#include <libraries/REBUS/dsp_simd.h>
+
+//---------------------------------------------------------------------
+// composition name
+// printed on startup during setup
+// added to audio recording filename if recording is enabled
+
+const char *COMPOSITION_name = "composition-block";
+
+//---------------------------------------------------------------------
+// composition state
+// initialize it in COMPOSITION_setup
+// or via C++ default (no-argument) constructor
+
+struct COMPOSITION
+{
+	// the oscillator is multipled by this each sample
+	std::complex<double> increment;
+
+	// the oscillator state
+	std::complex<double> oscillator;
+
+	// computed volume envelope, for retriggering
+	float rms;
+};
+
+//---------------------------------------------------------------------
+// called during setup
+// after REBUS setup is done
+
+inline
+bool COMPOSITION_setup(BelaContext *context, COMPOSITION *C)
+{
+	// initialize state
+	C->increment = 0;
+	C->oscillator = 0;
+	C->rms = 0;
+	return true;
+}
+
+//---------------------------------------------------------------------
+// called once per audio block (default 16 frames at 44100Hz sample rate)
+// each buffer has 'frames' items
+// store mutable state in the COMPOSITION struct, or in globals
+
+inline
+void COMPOSITION_renderBlock(BelaContext *context, COMPOSITION *C, unsigned int frames,
+  float *out[2], const float *in[2], const float *magnitude, const float *phase)
+{
+	// copy state to local variables
+	// so the compiler can keep them in registers for the whole block
+	std::complex<double> increment = C->increment;
+	std::complex<double> oscillator = C->oscillator;
+	float rms = C->rms;
+
+	// controls are mapped a chunk of frames at a time
+	// with the vectorised block functions from dsp_simd.h
+	const unsigned int CHUNK = 64;
+	for (unsigned int start = 0; start < frames; start += CHUNK)
+	{
+		unsigned int count = frames - start < CHUNK ? frames - start : CHUNK;
+		float m[CHUNK], f[CHUNK], c[CHUNK], s[CHUNK];
+		for (unsigned int k = 0; k < count; ++k)
+		{
+			// map the gain exponentially
+			// low magnitude gives rapid decay time (high frequency retrigger)
+			// high magnitude gives extended decay time (low frequency retrigger)
+			float gain = constrain(magnitude[start + k], 0.0f, 1.0f);
+			m[k] = map(gain, 0.0f, 1.0f, logf(0.99f), logf(0.999999f));
+
+			// map the phase linearly
+			// low phase gives low oscillator frequency
+			// high phase gives high oscillator frequency
+			f[k] = 0.25f * phase[start + k];
+		}
+		exp_block(m, m, count);
+		sincos_block(s, c, f, count);
+
+		for (unsigned int k = 0; k < count; ++k)
+		{
+			unsigned int n = start + k;
+
+			// combine them into the complex oscillator multiplier
+			increment = double(m[k]) * std::complex<double>(c[k], s[k]);
+
+			// rms (root mean square) envelope follower
+			// this is a simple low pass filter
+			// fed with the oscillator's squared magnitude
+			rms *= 0.99;
+			rms += 0.01 * std::norm(oscillator);
+
+			// check envelope against a threshold
+			// no square root is necessary, as both sides have been squared
+			if (rms < 3.0e-3f)
+			{
+				// the output is quiet
+				// retrigger the oscillator
+				oscillator += 0.5;
+			}
+
+			// update the oscillator
+			oscillator *= increment;
+
+			// output (soft clipped below)
+			out[0][n] = oscillator.real();
+			out[1][n] = oscillator.imag();
+		}
+	}
+
+	// soft clipping, vectorised over the whole block
+	fasttanh_block(out[0], out[0], frames);
+	fasttanh_block(out[1], out[1], frames);
+
+	// store state for the next block
+	C->increment = increment;
+	C->oscillator = oscillator;
+	C->rms = rms;
+}
+
+//---------------------------------------------------------------------
+// called during cleanup
+// do not free the composition struct, it will be deleted automatically
+// (it's possible to do the cleanup in the C++ destructor instead)
+
+inline
+void COMPOSITION_cleanup(BelaContext *context, COMPOSITION *C)
+{
+	// nothing to do for this composition
+}
+
+//---------------------------------------------------------------------
+// instantiate Bela API with default REBUS implementations
+// this should be the last line of code in each composition
+
+REBUS
+
+//---------------------------------------------------------------------
@@ -0,0 +1,357 @@
+//---------------------------------------------------------------------
+/*
+
+REBUS - Electromagnetic Interactions
+
+https://xname.cc/rebus
+
+accuracy and speed benchmark for the maths kernels in dsp_simd.h
+added 2026-10-16
+
+For each kernel and input range, evaluates the scalar, 4-wide and 8-wide
+versions (and the libm function they replace) on random inputs,
+reporting the maximum error against double precision libm
+and the time per value.
+
+Output is tab-separated with a header line,
+one line per kernel and range.
+Arguments select kernels whose name contains any of them
+(default all).
+
+*/
+
+//---------------------------------------------------------------------
+// dependencies
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <time.h>
+
+#include "libraries/REBUS/dsp_simd.h"
+
+// sample8 is passed by value without AVX, which GCC warns about
+#if defined(__GNUC__) && ! defined(__clang__)
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+//---------------------------------------------------------------------
+// parameters
+
+// values per call of a kernel
+#define BENCH_BLOCK 4096
+
+// random values per range for measuring the error
+#define BENCH_VALUES (1 << 22)
+
+// minimum time per kernel and range for measuring the speed
+#define BENCH_SECONDS 0.05
+
+//---------------------------------------------------------------------
+// kernels
+
+// output 'y' from input 'x', 'n' values (a multiple of 8)
+typedef void (*BENCH_RUN)(float *y, const float *x, int n);
+
+template <float (*F)(float)>
+static void BENCH_run1(float *y, const float *x, int n)
+{
+	for (int i = 0; i < n; ++i)
+	{
+		y[i] = F(x[i]);
+	}
+}
+
+template <sample4 (*F)(const sample4 &)>
+static void BENCH_run4(float *y, const float *x, int n)
+{
+	for (int i = 0; i < n; i += 4)
+	{
+		store4(y + i, F(load4(x + i)));
+	}
+}
+
+template <sample8 (*F)(const sample8 &)>
+static void BENCH_run8(float *y, const float *x, int n)
+{
+	for (int i = 0; i < n; i += 8)
+	{
+		store8(y + i, F(load8(x + i)));
+	}
+}
+
+template <void (*F)(float *, const float *, int)>
+static void BENCH_runn(float *y, const float *x, int n)
+{
+	F(y, x, n);
+}
+
+// libm float functions (wrapped, as they may be overloaded or builtins)
+static float BENCH_sinf(float x) { return sinf(x); }
+static float BENCH_cosf(float x) { return cosf(x); }
+static float BENCH_expf(float x) { return expf(x); }
+static float BENCH_exp2f(float x) { return exp2f(x); }
+static float BENCH_logf(float x) { return logf(x); }
+static float BENCH_log2f(float x) { return log2f(x); }
+static float BENCH_powf(float x) { return powf(x, 0.75f); }
+static float BENCH_tanhf(float x) { return tanhf(x); }
+static float BENCH_sinfold(float x) { return sinf(float(M_PI / 2) * x); }
+
+// pow with a fixed exponent
+static float BENCH_pow1(float x) { return pow1(x, 0.75f); }
+static sample4 BENCH_pow4(const sample4 &x) { return pow4(x, splat4(0.75f)); }
+static sample8 BENCH_pow8(const sample8 &x) { return pow8(x, splat8(0.75f)); }
+
+// double precision references
+static double BENCH_sin(double x) { return sin(x); }
+static double BENCH_cos(double x) { return cos(x); }
+static double BENCH_exp(double x) { return exp(x); }
+static double BENCH_exp2(double x) { return exp2(x); }
+static double BENCH_log(double x) { return log(x); }
+static double BENCH_log2(double x) { return log2(x); }
+static double BENCH_pow(double x) { return pow(x, 0.75); }
+static double BENCH_tanh(double x) { return tanh(x); }
+static double BENCH_sinefold(double x) { return sin(M_PI / 2 * x); }
+static double BENCH_cubicclip(double x) { x = fmin(fmax(x, -1), 1); return 1.5 * x - 0.5 * x * x * x; }
+static double BENCH_mtof(double x) { return 8.17579891564 * exp(0.0577622650 * x); }
+
+typedef struct
+{
+	// function family, selects the input ranges
+	const char *family;
+	const char *name;
+	BENCH_RUN run;
+	double (*reference)(double);
+} BENCH_KERNEL;
+
+static const BENCH_KERNEL BENCH_kernels[] =
+{
+	{ "sin", "sinf", BENCH_run1<BENCH_sinf>, BENCH_sin },
+	{ "sin", "sin1", BENCH_run1<sin1>, BENCH_sin },
+	{ "sin", "sin4", BENCH_run4<sin4>, BENCH_sin },
+	{ "sin", "sin8", BENCH_run8<sin8>, BENCH_sin },
+	{ "sin", "cosf", BENCH_run1<BENCH_cosf>, BENCH_cos },
+	{ "sin", "cos1", BENCH_run1<cos1>, BENCH_cos },
+	{ "sin", "cos4", BENCH_run4<cos4>, BENCH_cos },
+	{ "sin", "cos8", BENCH_run8<cos8>, BENCH_cos },
+	{ "exp", "expf", BENCH_run1<BENCH_expf>, BENCH_exp },
+	{ "exp", "exp1", BENCH_run1<exp1>, BENCH_exp },
+	{ "exp", "exp4", BENCH_run4<exp4>, BENCH_exp },
+	{ "exp", "exp8", BENCH_run8<exp8>, BENCH_exp },
+	{ "exp2", "exp2f", BENCH_run1<BENCH_exp2f>, BENCH_exp2 },
+	{ "exp2", "exp2_1", BENCH_run1<exp2_1>, BENCH_exp2 },
+	{ "exp2", "exp2_4", BENCH_run4<exp2_4>, BENCH_exp2 },
+	{ "exp2", "exp2_8", BENCH_run8<exp2_8>, BENCH_exp2 },
+	{ "log", "logf", BENCH_run1<BENCH_logf>, BENCH_log },
+	{ "log", "log1", BENCH_run1<log1>, BENCH_log },
+	{ "log", "log4", BENCH_run4<log4>, BENCH_log },
+	{ "log", "log8", BENCH_run8<log8>, BENCH_log },
+	{ "log", "log2f", BENCH_run1<BENCH_log2f>, BENCH_log2 },
+	{ "log", "log2_1", BENCH_run1<log2_1>, BENCH_log2 },
+	{ "log", "log2_4", BENCH_run4<log2_4>, BENCH_log2 },
+	{ "log", "log2_8", BENCH_run8<log2_8>, BENCH_log2 },
+	{ "pow", "powf(x,0.75)", BENCH_run1<BENCH_powf>, BENCH_pow },
+	{ "pow", "pow1(x,0.75)", BENCH_run1<BENCH_pow1>, BENCH_pow },
+	{ "pow", "pow4(x,0.75)", BENCH_run4<BENCH_pow4>, BENCH_pow },
+	{ "pow", "pow8(x,0.75)", BENCH_run8<BENCH_pow8>, BENCH_pow },
+	{ "tanh", "tanhf", BENCH_run1<BENCH_tanhf>, BENCH_tanh },
+	{ "tanh", "fasttanh", BENCH_run1<fasttanh>, BENCH_tanh },
+	{ "tanh", "fasttanh4", BENCH_run4<fasttanh4>, BENCH_tanh },
+	{ "tanh", "fasttanh8", BENCH_run8<fasttanh8>, BENCH_tanh },
+	{ "tanh", "fasttanh_block", BENCH_runn<fasttanh_block>, BENCH_tanh },
+	{ "sinefold", "sinf(pi/2*x)", BENCH_run1<BENCH_sinfold>, BENCH_sinefold },
+	{ "sinefold", "sinefold", BENCH_run1<sinefold>, BENCH_sinefold },
+	{ "sinefold", "sinefold4", BENCH_run4<sinefold4>, BENCH_sinefold },
+	{ "sinefold", "sinefold8", BENCH_run8<sinefold8>, BENCH_sinefold },
+	{ "cubicclip", "cubicclip", BENCH_run1<cubicclip>, BENCH_cubicclip },
+	{ "cubicclip", "cubicclip8", BENCH_run8<cubicclip8>, BENCH_cubicclip },
+	{ "mtof", "mtof", BENCH_run1<mtof>, BENCH_mtof },
+	{ "mtof", "mtof_block", BENCH_runn<mtof_block>, BENCH_mtof },
+};
+
+//---------------------------------------------------------------------
+// input ranges
+
+typedef enum
+{
+	// uniform in [lo, hi]
+	BENCH_UNIFORM,
+	// any finite float
+	BENCH_FINITE,
+	// any positive normal float
+	BENCH_POSITIVE
+} BENCH_DISTRIBUTION;
+
+typedef struct
+{
+	const char *family;
+	const char *name;
+	BENCH_DISTRIBUTION distribution;
+	double lo, hi;
+	// error relative to the reference, or absolute
+	bool relative;
+} BENCH_RANGE;
+
+static const BENCH_RANGE BENCH_ranges[] =
+{
+	{ "sin", "|x|<=2pi", BENCH_UNIFORM, -2 * M_PI, 2 * M_PI, false },
+	{ "sin", "|x|<=1e3", BENCH_UNIFORM, -1e3, 1e3, false },
+	{ "sin", "|x|<=1e5", BENCH_UNIFORM, -1e5, 1e5, false },
+	{ "sin", "|x|<=1e7", BENCH_UNIFORM, -1e7, 1e7, false },
+	{ "sin", "finite", BENCH_FINITE, 0, 0, false },
+	{ "exp", "|x|<=1", BENCH_UNIFORM, -1, 1, true },
+	{ "exp", "|x|<=87", BENCH_UNIFORM, -87, 87, true },
+	{ "exp2", "|x|<=1", BENCH_UNIFORM, -1, 1, true },
+	{ "exp2", "|x|<=126", BENCH_UNIFORM, -126, 126, true },
+	{ "log", "[0.5,2]", BENCH_UNIFORM, 0.5, 2, false },
+	{ "log", "x>0", BENCH_POSITIVE, 0, 0, false },
+	{ "pow", "[0,1]", BENCH_UNIFORM, 0, 1, true },
+	{ "pow", "x>0", BENCH_POSITIVE, 0, 0, true },
+	{ "tanh", "|x|<=1", BENCH_UNIFORM, -1, 1, false },
+	{ "tanh", "|x|<=10", BENCH_UNIFORM, -10, 10, false },
+	{ "sinefold", "|x|<=1", BENCH_UNIFORM, -1, 1, false },
+	{ "sinefold", "|x|<=1e3", BENCH_UNIFORM, -1e3, 1e3, false },
+	{ "cubicclip", "|x|<=2", BENCH_UNIFORM, -2, 2, false },
+	{ "mtof", "[0,127]", BENCH_UNIFORM, 0, 127, true },
+};
+
+//---------------------------------------------------------------------
+
+static inline double BENCH_now(void)
+{
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + t.tv_nsec * 1.0e-9;
+}
+
+// xorshift, fixed seed so that runs are comparable
+static uint32_t BENCH_state = 0x12345678;
+static inline uint32_t BENCH_random(void)
+{
+	BENCH_state ^= BENCH_state << 13;
+	BENCH_state ^= BENCH_state >> 17;
+	BENCH_state ^= BENCH_state << 5;
+	return BENCH_state;
+}
+
+// Fill 'x' with random values in the range.
+static void BENCH_input(float *x, int n, const BENCH_RANGE *r)
+{
+	for (int i = 0; i < n; ++i)
+	{
+		switch (r->distribution)
+		{
+			case BENCH_UNIFORM:
+			{
+				x[i] = r->lo + (r->hi - r->lo) * (BENCH_random() / 4294967296.0);
+				break;
+			}
+			case BENCH_FINITE:
+			case BENCH_POSITIVE:
+			{
+				float f;
+				do
+				{
+					uint32_t u = BENCH_random();
+					if (r->distribution == BENCH_POSITIVE)
+					{
+						u &= 0x7fffffff;
+					}
+					memcpy(&f, &u, sizeof(f));
+				}
+				while (! std::isfinite(f) || (r->distribution == BENCH_POSITIVE && ! std::isnormal(f)));
+				x[i] = f;
+				break;
+			}
+		}
+	}
+}
+
+// Maximum error of the kernel over random values in the range.
+static double BENCH_error(const BENCH_KERNEL *k, const BENCH_RANGE *r)
+{
+	std::vector<float> x(BENCH_BLOCK), y(BENCH_BLOCK);
+	double error = 0;
+	BENCH_state = 0x12345678;
+	for (int v = 0; v < BENCH_VALUES; v += BENCH_BLOCK)
+	{
+		BENCH_input(&x[0], BENCH_BLOCK, r);
+		k->run(&y[0], &x[0], BENCH_BLOCK);
+		for (int i = 0; i < BENCH_BLOCK; ++i)
+		{
+			double reference = k->reference(x[i]);
+			if (! std::isfinite(reference))
+			{
+				continue;
+			}
+			double e = fabs(y[i] - reference);
+			if (r->relative)
+			{
+				e /= fmax(fabs(reference), 1.0e-300);
+			}
+			if (! (e <= error)) // also catches NaN
+			{
+				error = std::isnan(e) ? INFINITY : e;
+			}
+		}
+	}
+	return error;
+}
+
+// Time per value of the kernel, in nanoseconds.
+static double BENCH_speed(const BENCH_KERNEL *k, const BENCH_RANGE *r)
+{
+	std::vector<float> x(BENCH_BLOCK), y(BENCH_BLOCK);
+	BENCH_state = 0x12345678;
+	BENCH_input(&x[0], BENCH_BLOCK, r);
+	k->run(&y[0], &x[0], BENCH_BLOCK); // warm up
+	long values = 0;
+	double start = BENCH_now(), elapsed;
+	do
+	{
+		for (int repeat = 0; repeat < 16; ++repeat)
+		{
+			k->run(&y[0], &x[0], BENCH_BLOCK);
+		}
+		values += 16 * BENCH_BLOCK;
+		elapsed = BENCH_now() - start;
+	}
+	while (elapsed < BENCH_SECONDS);
+	// keep the results alive
+	volatile float sink = y[0];
+	(void) sink;
+	return elapsed * 1.0e9 / values;
+}
+
+//---------------------------------------------------------------------
+
+int main(int argc, char **argv)
+{
+	printf("kernel\trange\terror\tmax_error\tns_per_value\n");
+	for (const BENCH_KERNEL &k : BENCH_kernels)
+	{
+		bool selected = argc <= 1;
+		for (int a = 1; a < argc; ++a)
+		{
+			selected |= strstr(k.name, argv[a]) != nullptr;
+		}
+		if (! selected)
+		{
+			continue;
+		}
+		for (const BENCH_RANGE &r : BENCH_ranges)
+		{
+			if (strcmp(k.family, r.family))
+			{
+				continue;
+			}
+			printf("%s\t%s\t%s\t%.3g\t%.3f\n", k.name, r.name, r.relative ? "rel" : "abs", BENCH_error(&k, &r), BENCH_speed(&k, &r));
+			fflush(stdout);
+		}
+	}
+	return 0;
+}
+
+//---------------------------------------------------------------------
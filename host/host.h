@@ -0,0 +1,193 @@
+#pragma once
+//---------------------------------------------------------------------
+/*
+
+REBUS - Electromagnetic Interactions
+
+https://xname.cc/rebus
+
+common code for the host programs
+added 2026-10-16
+
+Include after the composition source,
+which provides the REBUS configuration (pins and mapping).
+
+*/
+
+//---------------------------------------------------------------------
+// dependencies
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <sndfile.h>
+
+//---------------------------------------------------------------------
+// defaults match the Bela defaults
+
+#define HOST_BLOCK_SIZE 16
+#define HOST_ANALOG_CHANNELS 8
+
+//---------------------------------------------------------------------
+// input file channel layout, as written by the REBUS recorder
+// (the REBUS channel names may be hidden by composition macros)
+
+enum HOST_CHANNEL
+{
+	HOST_GAIN = 0,
+	HOST_PHASE = 1,
+	HOST_OUT_LEFT = 2,
+	HOST_OUT_RIGHT = 3,
+	HOST_IN_LEFT = 4,
+	HOST_IN_RIGHT = 5,
+	HOST_CHANNELS = 6
+};
+
+//---------------------------------------------------------------------
+// host state
+
+struct HOST
+{
+	// interleaved input in the recorder layout
+	std::vector<float> input;
+	sf_count_t frames;
+	int sampleRate;
+
+	// analog rate is audio rate * numerator / denominator
+	int analogNumerator;
+	int analogDenominator;
+
+	// buffers for the context
+	std::vector<float> audioIn;
+	std::vector<float> audioOut;
+	std::vector<float> analogIn;
+	std::vector<float> analogOut;
+
+	BelaContext context;
+};
+
+//---------------------------------------------------------------------
+// the recorded controls have been mapped to 0..1 by the REBUS library,
+// undo the mapping so that the composition sees raw analog readings
+
+static inline float HOST_unmap(float x, float lo, float hi)
+{
+	return lo + x * (hi - lo);
+}
+
+//---------------------------------------------------------------------
+// read the whole input file
+
+bool HOST_read(HOST *H, const char *path)
+{
+	SF_INFO info = {};
+	SNDFILE *in = sf_open(path, SFM_READ, &info);
+	if (! in)
+	{
+		fprintf(stderr, "error: could not open %s for reading\n", path);
+		return false;
+	}
+	if (info.channels != HOST_CHANNELS)
+	{
+		fprintf(stderr, "error: expected %d channels, got %d\n", HOST_CHANNELS, info.channels);
+		sf_close(in);
+		return false;
+	}
+	H->input.resize(HOST_CHANNELS * (size_t) info.frames);
+	H->frames = sf_readf_float(in, &H->input[0], info.frames);
+	H->sampleRate = info.samplerate;
+	sf_close(in);
+	return true;
+}
+
+//---------------------------------------------------------------------
+// synthesize an input, for when no recording is available:
+// slow wandering controls (incommensurate sine waves)
+// with a little noise, and quiet noise on the audio inputs
+
+void HOST_synthesize(HOST *H, double seconds, int sampleRate)
+{
+	H->sampleRate = sampleRate;
+	H->frames = seconds * sampleRate;
+	H->input.assign(HOST_CHANNELS * (size_t) H->frames, 0.0f);
+	srand(1);
+	for (sf_count_t n = 0; n < H->frames; ++n)
+	{
+		double t = n / (double) sampleRate;
+		float *frame = &H->input[HOST_CHANNELS * n];
+		frame[HOST_GAIN] = 0.5 + 0.3 * sin(2 * M_PI * 0.13 * t) + 0.15 * sin(2 * M_PI * 0.71 * t) + 0.001 * (rand() / (double) RAND_MAX - 0.5);
+		frame[HOST_PHASE] = 0.5 + 0.3 * sin(2 * M_PI * 0.07 * t + 1) + 0.15 * sin(2 * M_PI * 1.1 * t) + 0.001 * (rand() / (double) RAND_MAX - 0.5);
+		frame[HOST_IN_LEFT] = 0.01 * (rand() / (double) RAND_MAX - 0.5);
+		frame[HOST_IN_RIGHT] = 0.01 * (rand() / (double) RAND_MAX - 0.5);
+	}
+}
+
+//---------------------------------------------------------------------
+// set up the context for a block size and analog channel count
+
+bool HOST_context(HOST *H, int blockSize, int analogChannels)
+{
+	// analog sample rate depends on the number of analog channels
+	// as on Bela: 8 channels at half, 4 at the same, 2 at double audio rate
+	H->analogNumerator = analogChannels == 2 ? 2 : 1;
+	H->analogDenominator = analogChannels == 8 ? 2 : 1;
+	if ((blockSize * H->analogNumerator) % H->analogDenominator)
+	{
+		fprintf(stderr, "error: block size %d is too small for %d analog channels\n", blockSize, analogChannels);
+		return false;
+	}
+	if (! (PHASE_PIN < analogChannels && MAGNITUDE_PIN < analogChannels))
+	{
+		fprintf(stderr, "error: control pins %d and %d need more than %d analog channels\n", PHASE_PIN, MAGNITUDE_PIN, analogChannels);
+		return false;
+	}
+	const int analogFrames = blockSize * H->analogNumerator / H->analogDenominator;
+
+	H->audioIn.assign(2 * blockSize, 0.0f);
+	H->audioOut.assign(2 * blockSize, 0.0f);
+	H->analogIn.assign(analogChannels * analogFrames, 0.0f);
+	H->analogOut.assign(analogChannels * analogFrames, 0.0f);
+
+	BelaContext *context = &H->context;
+	*context = BelaContext();
+	context->audioIn = &H->audioIn[0];
+	context->audioOut = &H->audioOut[0];
+	context->analogIn = &H->analogIn[0];
+	context->analogOut = &H->analogOut[0];
+	context->audioFrames = blockSize;
+	context->audioInChannels = 2;
+	context->audioOutChannels = 2;
+	context->audioSampleRate = H->sampleRate;
+	context->analogFrames = analogFrames;
+	context->analogInChannels = analogChannels;
+	context->analogOutChannels = analogChannels;
+	context->analogSampleRate = H->sampleRate * H->analogNumerator / (float) H->analogDenominator;
+	snprintf(context->projectName, sizeof(context->projectName), "%s", COMPOSITION_name);
+	return true;
+}
+
+//---------------------------------------------------------------------
+// copy one block of input starting at 'frame' into the context
+
+void HOST_input(HOST *H, sf_count_t frame)
+{
+	BelaContext *context = &H->context;
+	const float *block = &H->input[HOST_CHANNELS * frame];
+	for (unsigned int n = 0; n < context->audioFrames; ++n)
+	{
+		H->audioIn[2 * n + 0] = block[HOST_CHANNELS * n + HOST_IN_LEFT];
+		H->audioIn[2 * n + 1] = block[HOST_CHANNELS * n + HOST_IN_RIGHT];
+	}
+	for (unsigned int m = 0; m < context->analogFrames; ++m)
+	{
+		// nearest audio frame to this analog frame
+		unsigned int n = m * H->analogDenominator / H->analogNumerator;
+		float *analog = &H->analogIn[context->analogInChannels * m];
+		analog[PHASE_PIN] = HOST_unmap(block[HOST_CHANNELS * n + HOST_PHASE], PHASE_MIN, PHASE_MAX);
+		analog[MAGNITUDE_PIN] = HOST_unmap(block[HOST_CHANNELS * n + HOST_GAIN], MAGNITUDE_MIN, MAGNITUDE_MAX);
+	}
+}
+
+//---------------------------------------------------------------------
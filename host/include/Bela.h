@@ -0,0 +1,183 @@
+#pragma once
+//---------------------------------------------------------------------
+/*
+
+REBUS - Electromagnetic Interactions
+
+https://xname.cc/rebus
+
+minimal Bela stand-in for running compositions on a host computer
+added 2026-10-16
+
+Only the parts of the Bela API used by the REBUS library
+and the compositions in this repository are provided.
+Everything runs in a single thread:
+auxiliary tasks run to completion when they are scheduled,
+so offline rendering is deterministic.
+
+*/
+
+//---------------------------------------------------------------------
+// dependencies
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstdint>
+
+//---------------------------------------------------------------------
+// context
+
+// subset of the Bela context structure
+// all buffers are interleaved
+struct BelaContext
+{
+	const float *audioIn;
+	float *audioOut;
+	const float *analogIn;
+	float *analogOut;
+
+	uint32_t audioFrames;
+	uint32_t audioInChannels;
+	uint32_t audioOutChannels;
+	float audioSampleRate;
+
+	uint32_t analogFrames;
+	uint32_t analogInChannels;
+	uint32_t analogOutChannels;
+	float analogSampleRate;
+
+	uint64_t audioFramesElapsed;
+
+	uint32_t flags;
+
+	char projectName[256];
+};
+
+//---------------------------------------------------------------------
+// realtime printing
+
+static inline int rt_printf(const char *format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	int ret = vfprintf(stderr, format, args);
+	va_end(args);
+	return ret;
+}
+
+//---------------------------------------------------------------------
+// auxiliary tasks
+
+typedef void *AuxiliaryTask;
+
+// tasks are not threads on the host: they run when scheduled
+struct HOST_TASK
+{
+	void (*callback)(void *);
+	void *arg;
+	const char *name;
+};
+
+#define HOST_TASKS_MAX 16
+
+static HOST_TASK HOST_tasks[HOST_TASKS_MAX];
+static int HOST_taskCount = 0;
+
+static inline AuxiliaryTask Bela_createAuxiliaryTask(void (*callback)(void *), int priority, const char *name, void *arg = nullptr)
+{
+	(void) priority;
+	// reuse the task if it was created before
+	// (the benchmark runs setup many times)
+	for (int i = 0; i < HOST_taskCount; ++i)
+	{
+		if (HOST_tasks[i].callback == callback && HOST_tasks[i].arg == arg)
+		{
+			return &HOST_tasks[i];
+		}
+	}
+	if (HOST_taskCount >= HOST_TASKS_MAX)
+	{
+		return nullptr;
+	}
+	HOST_TASK *task = &HOST_tasks[HOST_taskCount++];
+	task->callback = callback;
+	task->arg = arg;
+	task->name = name;
+	return task;
+}
+
+static inline int Bela_scheduleAuxiliaryTask(AuxiliaryTask t)
+{
+	HOST_TASK *task = (HOST_TASK *) t;
+	if (! task)
+	{
+		return -1;
+	}
+	task->callback(task->arg);
+	return 0;
+}
+
+//---------------------------------------------------------------------
+// audio and analog input and output
+
+static inline float audioRead(BelaContext *context, int frame, int channel)
+{
+	return context->audioIn[frame * context->audioInChannels + channel];
+}
+
+static inline void audioWrite(BelaContext *context, int frame, int channel, float value)
+{
+	context->audioOut[frame * context->audioOutChannels + channel] = value;
+}
+
+static inline float analogRead(BelaContext *context, int frame, int channel)
+{
+	return context->analogIn[frame * context->analogInChannels + channel];
+}
+
+static inline void analogWriteOnce(BelaContext *context, int frame, int channel, float value)
+{
+	context->analogOut[frame * context->analogOutChannels + channel] = value;
+}
+
+static inline void analogWrite(BelaContext *context, int frame, int channel, float value)
+{
+	for (unsigned int f = frame; f < context->analogFrames; ++f)
+	{
+		analogWriteOnce(context, f, channel, value);
+	}
+}
+
+//---------------------------------------------------------------------
+// utilities
+
+static inline float map(float x, float in_min, float in_max, float out_min, float out_max)
+{
+	return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+static inline float constrain(float x, float min_val, float max_val)
+{
+	if (x < min_val) return min_val;
+	if (x > max_val) return max_val;
+	return x;
+}
+
+static inline float min(float x, float y)
+{
+	return x < y ? x : y;
+}
+
+static inline float max(float x, float y)
+{
+	return x > y ? x : y;
+}
+
+//---------------------------------------------------------------------
+// entry points, implemented by the composition (via the REBUS macro)
+
+bool setup(BelaContext *context, void *userData);
+void render(BelaContext *context, void *userData);
+void cleanup(BelaContext *context, void *userData);
+
+//---------------------------------------------------------------------
@@ -0,0 +1,24 @@
+#pragma once
+//---------------------------------------------------------------------
+// minimal Bela Scope stand-in for the host build
+// there is no oscilloscope display, so logged data is discarded
+
+class Scope
+{
+public:
+	void setup(unsigned int numChannels, float sampleRate)
+	{
+		(void) numChannels;
+		(void) sampleRate;
+	}
+	void log(const float *values)
+	{
+		(void) values;
+	}
+	template <typename... T>
+	void log(T... values)
+	{
+	}
+};
+
+//---------------------------------------------------------------------
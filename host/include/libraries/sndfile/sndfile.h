@@ -0,0 +1,8 @@
+#pragma once
+//---------------------------------------------------------------------
+// Bela provides libsndfile under this path,
+// on the host the system library is used instead
+
+#include <sndfile.h>
+
+//---------------------------------------------------------------------
@@ -0,0 +1,220 @@
+//---------------------------------------------------------------------
+/*
+
+REBUS - Electromagnetic Interactions
+
+https://xname.cc/rebus
+
+render-time benchmark for REBUS compositions on a host computer
+added 2026-10-16
+
+Runs setup, render and cleanup for each block size
+with recorded (or synthesized) control gestures,
+timing every render call,
+and reports the cost per sample, the worst-case block time,
+block time percentiles, and the implied CPU load and headroom
+against the audio deadline at the input sample rate.
+
+Output is tab-separated with a header line (or JSON lines with -j),
+one line per block size, for comparing runs and picking block sizes.
+
+*/
+
+//---------------------------------------------------------------------
+// the composition
+
+#ifndef COMPOSITION_SOURCE
+#error COMPOSITION_SOURCE must be defined (see Makefile)
+#endif
+
+#include COMPOSITION_SOURCE
+
+//---------------------------------------------------------------------
+// dependencies of the benchmark
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <time.h>
+#include <unistd.h>
+
+#include "host.h"
+
+//---------------------------------------------------------------------
+// default sample rate of the synthesized input
+
+#define BENCH_SAMPLE_RATE 44100
+
+// length of the synthesized input, in seconds
+#define BENCH_SECONDS 60
+
+//---------------------------------------------------------------------
+
+static inline double BENCH_now(void)
+{
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec * 1.0e9 + t.tv_nsec;
+}
+
+// nearest-rank percentile of sorted values
+static inline double BENCH_percentile(const std::vector<double> &sorted, double p)
+{
+	size_t i = std::ceil(p / 100 * sorted.size());
+	i = i > 0 ? i - 1 : 0;
+	i = i < sorted.size() ? i : sorted.size() - 1;
+	return sorted[i];
+}
+
+//---------------------------------------------------------------------
+
+static void BENCH_usage(const char *argv0)
+{
+	fprintf(stderr,
+		"usage: %s [-j] [-a analogchannels] [-s seconds] [-r rate] [blocksize...] [-i in6ch.wav]\n"
+		"  -j  output JSON lines instead of tab-separated values\n"
+		"  -a  analog channels: 2, 4 or 8 (default %d)\n"
+		"  -s  length of synthesized input when no file is given (default %d)\n"
+		"  -r  sample rate of synthesized input when no file is given (default %d)\n"
+		"  -i  6-channel recording to use as input\n"
+		"  block sizes default to 16 32 64 128 256 512 1024 2048\n"
+		, argv0, HOST_ANALOG_CHANNELS, BENCH_SECONDS, BENCH_SAMPLE_RATE);
+}
+
+int main(int argc, char **argv)
+{
+	bool json = false;
+	int analogChannels = HOST_ANALOG_CHANNELS;
+	double seconds = BENCH_SECONDS;
+	int sampleRate = BENCH_SAMPLE_RATE;
+	const char *inPath = nullptr;
+	int opt;
+	while ((opt = getopt(argc, argv, "ja:s:r:i:")) != -1)
+	{
+		switch (opt)
+		{
+			case 'j': json = true; break;
+			case 'a': analogChannels = atoi(optarg); break;
+			case 's': seconds = atof(optarg); break;
+			case 'r': sampleRate = atoi(optarg); break;
+			case 'i': inPath = optarg; break;
+			default: BENCH_usage(argv[0]); return 1;
+		}
+	}
+	if (! (analogChannels == 2 || analogChannels == 4 || analogChannels == 8) || ! (seconds > 0) || ! (sampleRate > 0))
+	{
+		BENCH_usage(argv[0]);
+		return 1;
+	}
+	std::vector<int> blockSizes;
+	for (int i = optind; i < argc; ++i)
+	{
+		int blockSize = atoi(argv[i]);
+		if (blockSize <= 0)
+		{
+			BENCH_usage(argv[0]);
+			return 1;
+		}
+		blockSizes.push_back(blockSize);
+	}
+	if (blockSizes.empty())
+	{
+		for (int blockSize = 16; blockSize <= 2048; blockSize <<= 1)
+		{
+			blockSizes.push_back(blockSize);
+		}
+	}
+
+	HOST H;
+	if (inPath)
+	{
+		if (! HOST_read(&H, inPath))
+		{
+			return 1;
+		}
+	}
+	else
+	{
+		HOST_synthesize(&H, seconds, sampleRate);
+	}
+
+	if (! json)
+	{
+		printf("composition\tblock\tframes\tns_per_sample\tmean_us\tp50_us\tp90_us\tp99_us\tp999_us\tmax_us\tjitter_us\tdeadline_us\tload\tworst_load\theadroom\n");
+	}
+
+	int retval = 0;
+	for (int blockSize : blockSizes)
+	{
+		if (! HOST_context(&H, blockSize, analogChannels))
+		{
+			retval = 1;
+			continue;
+		}
+		BelaContext *context = &H.context;
+		if (! setup(context, nullptr))
+		{
+			fprintf(stderr, "error: setup failed for block size %d\n", blockSize);
+			retval = 1;
+			continue;
+		}
+
+		// time each block
+		std::vector<double> times;
+		times.reserve(H.frames / blockSize + 1);
+		for (sf_count_t frame = 0; frame + blockSize <= H.frames; frame += blockSize)
+		{
+			HOST_input(&H, frame);
+			double start = BENCH_now();
+			render(context, nullptr);
+			double end = BENCH_now();
+			times.push_back(end - start);
+			context->audioFramesElapsed += blockSize;
+		}
+		cleanup(context, nullptr);
+		if (times.empty())
+		{
+			fprintf(stderr, "error: input is shorter than block size %d\n", blockSize);
+			retval = 1;
+			continue;
+		}
+
+		// statistics (times in nanoseconds)
+		double total = 0;
+		for (double t : times)
+		{
+			total += t;
+		}
+		double frames = times.size() * (double) blockSize;
+		double mean = total / times.size();
+		std::sort(times.begin(), times.end());
+		double p50 = BENCH_percentile(times, 50);
+		double p90 = BENCH_percentile(times, 90);
+		double p99 = BENCH_percentile(times, 99);
+		double p999 = BENCH_percentile(times, 99.9);
+		double worst = times.back();
+		double deadline = 1.0e9 * blockSize / H.sampleRate;
+		double load = mean / deadline;
+		double worstLoad = worst / deadline;
+
+		if (json)
+		{
+			printf("{\"composition\": \"%s\", \"block\": %d, \"frames\": %.0f, \"ns_per_sample\": %.3f, \"mean_us\": %.3f, \"p50_us\": %.3f, \"p90_us\": %.3f, \"p99_us\": %.3f, \"p999_us\": %.3f, \"max_us\": %.3f, \"jitter_us\": %.3f, \"deadline_us\": %.3f, \"load\": %.6f, \"worst_load\": %.6f, \"headroom\": %.6f}\n",
+				COMPOSITION_name, blockSize, frames, total / frames,
+				mean / 1000, p50 / 1000, p90 / 1000, p99 / 1000, p999 / 1000, worst / 1000, (p99 - p50) / 1000,
+				deadline / 1000, load, worstLoad, 1 - worstLoad);
+		}
+		else
+		{
+			printf("%s\t%d\t%.0f\t%.3f\t%.3f\t%.3f\t%.3f\t%.3f\t%.3f\t%.3f\t%.3f\t%.3f\t%.6f\t%.6f\t%.6f\n",
+				COMPOSITION_name, blockSize, frames, total / frames,
+				mean / 1000, p50 / 1000, p90 / 1000, p99 / 1000, p999 / 1000, worst / 1000, (p99 - p50) / 1000,
+				deadline / 1000, load, worstLoad, 1 - worstLoad);
+		}
+		fflush(stdout);
+	}
+	return retval;
+}
+
+//---------------------------------------------------------------------
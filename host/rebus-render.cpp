@@ -0,0 +1,115 @@
+//---------------------------------------------------------------------
+/*
+
+REBUS - Electromagnetic Interactions
+
+https://xname.cc/rebus
+
+offline renderer for REBUS compositions on a host computer
+added 2026-10-16
+
+Reads a 6-channel WAV in the layout written by the REBUS recorder
+(magnitude, phase, audio out left/right, audio in left/right),
+feeds the controls and audio input to the composition
+as fast as possible, and writes the audio output to a WAV.
+
+The composition source is included directly (see Makefile),
+so it is compiled in the same translation unit as this file
+and sees the same REBUS configuration.
+
+*/
+
+//---------------------------------------------------------------------
+// the composition
+
+#ifndef COMPOSITION_SOURCE
+#error COMPOSITION_SOURCE must be defined (see Makefile)
+#endif
+
+#include COMPOSITION_SOURCE
+
+//---------------------------------------------------------------------
+// dependencies of the renderer
+
+#include <unistd.h>
+
+#include "host.h"
+
+//---------------------------------------------------------------------
+
+static void HOST_usage(const char *argv0)
+{
+	fprintf(stderr,
+		"usage: %s [-b blocksize] [-a analogchannels] in6ch.wav out.wav\n"
+		"  -b  audio frames per block (default %d)\n"
+		"  -a  analog channels: 2, 4 or 8 (default %d)\n"
+		, argv0, HOST_BLOCK_SIZE, HOST_ANALOG_CHANNELS);
+}
+
+int main(int argc, char **argv)
+{
+	int blockSize = HOST_BLOCK_SIZE;
+	int analogChannels = HOST_ANALOG_CHANNELS;
+	int opt;
+	while ((opt = getopt(argc, argv, "b:a:")) != -1)
+	{
+		switch (opt)
+		{
+			case 'b': blockSize = atoi(optarg); break;
+			case 'a': analogChannels = atoi(optarg); break;
+			default: HOST_usage(argv[0]); return 1;
+		}
+	}
+	if (argc - optind != 2 || blockSize <= 0 || ! (analogChannels == 2 || analogChannels == 4 || analogChannels == 8))
+	{
+		HOST_usage(argv[0]);
+		return 1;
+	}
+	const char *inPath = argv[optind];
+	const char *outPath = argv[optind + 1];
+
+	HOST H;
+	if (! HOST_read(&H, inPath))
+	{
+		return 1;
+	}
+	if (! HOST_context(&H, blockSize, analogChannels))
+	{
+		return 1;
+	}
+	BelaContext *context = &H.context;
+
+	// open the output file
+	SF_INFO outInfo = {};
+	outInfo.channels = 2;
+	outInfo.samplerate = H.sampleRate;
+	outInfo.format = SF_FORMAT_WAV | SF_FORMAT_FLOAT;
+	SNDFILE *outFile = sf_open(outPath, SFM_WRITE, &outInfo);
+	if (! outFile)
+	{
+		fprintf(stderr, "error: could not open %s for writing\n", outPath);
+		return 1;
+	}
+
+	if (! setup(context, nullptr))
+	{
+		fprintf(stderr, "error: setup failed\n");
+		sf_close(outFile);
+		return 1;
+	}
+
+	// render whole blocks, the last partial block is dropped
+	for (sf_count_t frame = 0; frame + blockSize <= H.frames; frame += blockSize)
+	{
+		HOST_input(&H, frame);
+		render(context, nullptr);
+		sf_writef_float(outFile, &H.audioOut[0], blockSize);
+		context->audioFramesElapsed += blockSize;
+	}
+
+	cleanup(context, nullptr);
+	sf_close(outFile);
+	return 0;
+}
+
+//---------------------------------------------------------------------
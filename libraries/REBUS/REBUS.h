@@ -12,6 +12,14 @@ based on workshop template by xname 2023
 audio recorder based on an example found on Bela forums
 converted to library 2023-06-28
 configurable scope and record channels added 2024-07-22
+optional block rendering API added 2026-10-16
+render profiling added 2026-10-16
+control rate conditioning added 2026-10-16
+analog frame rate detection added 2026-10-16
+lock-free recording ring buffer added 2026-10-16
+recording formats and control sidecar added 2026-10-16
+segmented crash-safe recording added 2026-10-16
+overrun accounting added 2026-10-16
 
 */
 
@@ -55,8 +63,32 @@ enum CHANNEL
 // #define RECORD_CHANNEL_x y to configure recording channels
 // where x is in 1 to 6 and y is a channel name listed above
 //
-// with default settings, recording adds 10-15% to the CPU load
-// this additional cost reduces with larger block sizes
+// #define RECORD_FORMAT f to set the sample format of the recording
+// where f is one of the RECORD_FORMAT_ values listed below
+// (default RECORD_FORMAT_FLOAT, 32bit float WAV, about 60MB/min at 6ch)
+// conversion is done by the non-realtime writer, not the audio thread
+//
+// #define RECORD_CONTROL_DECIMATION n to record magnitude and phase
+// once every n audio frames in a separate 2ch float "-control.wav" file
+// instead of as full rate audio channels
+// (n must divide the sample rate, so the sidecar rate is exact,
+// for example 32 at 44100 Hz does not, but 25, 45 or 49 do)
+// (the default channels then become out x2, in x2)
+//
+// #define RECORD_SEGMENT_SECONDS n to start a new numbered file
+// every n seconds (default 0: one file for the whole run)
+// #define RECORD_SEGMENTS_KEEP n to delete old segments, keeping the last n
+// (default 0: keep all; with 60 second segments, 30 keeps the last 30mins)
+// #define RECORD_SYNC_SECONDS n to update the file header and flush to
+// storage every n seconds, so that a crash or power cut leaves a
+// readable file missing at most that much (default 10, 0 to disable)
+//
+// recording data is written directly into a lock-free ring buffer
+// that is drained to the sound file by a non-realtime task
+// #define RECORD_RING_FRAMES n to set the ring buffer size in frames
+// (default 65536, about 1.5 seconds at 44100 Hz)
+// #define RECORD_BATCH_FRAMES n to set how many frames are
+// collected before waking the writer (default 4096)
 
 #ifdef RECORD
 // RECORD was defined externally, hide messages
@@ -68,13 +100,59 @@ enum CHANNEL
 #define RECORD 0
 #endif
 
+// recording sample formats
+// 32bit float WAV, lossless, biggest
+#define RECORD_FORMAT_FLOAT 0
+// 16bit PCM WAV, half the size of float
+#define RECORD_FORMAT_PCM_16 1
+// 24bit PCM WAV, three quarters the size of float
+#define RECORD_FORMAT_PCM_24 2
+// 24bit FLAC, compressed, more CPU in the writer
+#define RECORD_FORMAT_FLAC 3
+
+// set recorder format preferences
+#if RECORD
+#ifndef RECORD_FORMAT
+#define RECORD_FORMAT RECORD_FORMAT_FLOAT
+#endif
+#if ! (RECORD_FORMAT_FLOAT <= RECORD_FORMAT && RECORD_FORMAT <= RECORD_FORMAT_FLAC)
+#error RECORD_FORMAT must be one of the RECORD_FORMAT_ values
+#endif
+#ifndef RECORD_CONTROL_DECIMATION
+#define RECORD_CONTROL_DECIMATION 0
+#endif
+#ifndef RECORD_SEGMENT_SECONDS
+#define RECORD_SEGMENT_SECONDS 0
+#endif
+#ifndef RECORD_SEGMENTS_KEEP
+#define RECORD_SEGMENTS_KEEP 0
+#endif
+#if RECORD_SEGMENTS_KEEP && ! RECORD_SEGMENT_SECONDS
+#error RECORD_SEGMENTS_KEEP needs RECORD_SEGMENT_SECONDS
+#endif
+#ifndef RECORD_SYNC_SECONDS
+#define RECORD_SYNC_SECONDS 10
+#endif
+#endif
+
 // set recorder channel preferences
 #if RECORD
+#if RECORD_CONTROL_DECIMATION && ! defined(RECORD_CHANNELS)
+// controls are in the sidecar file, record only audio
+#define RECORD_CHANNELS 4
+#define RECORD_CHANNEL_1 OUT_LEFT
+#define RECORD_CHANNEL_2 OUT_RIGHT
+#define RECORD_CHANNEL_3 IN_LEFT
+#define RECORD_CHANNEL_4 IN_RIGHT
+#define RECORD_CHANNELS_DEFINED 0
+#endif
 #ifdef RECORD_CHANNELS
 #if ! (1 <= RECORD_CHANNELS && RECORD_CHANNELS <= 6)
 #error RECORD_CHANNELS must be between 1 and 6 inclusive
 #endif
+#ifndef RECORD_CHANNELS_DEFINED
 #define RECORD_CHANNELS_DEFINED 1
+#endif
 #else
 #define RECORD_CHANNELS_DEFINED 0
 #define RECORD_CHANNELS 6
@@ -95,7 +173,7 @@ enum CHANNEL
 #define RECORD_CHANNEL_5 IN_LEFT
 #endif
 #ifndef RECORD_CHANNEL_6
-#define RECORD_CHANNEL_6 IN_OUT
+#define RECORD_CHANNEL_6 IN_RIGHT
 #endif
 #endif
 
@@ -163,8 +241,14 @@ enum CHANNEL
 #if MODE == MODE_REBUS
 
 // the antenna is connected to these analog inputs
+// can be overriden via compilation flags
+// (both must be below the number of analog input channels)
+#ifndef PHASE_PIN
 #define PHASE_PIN 0
+#endif
+#ifndef MAGNITUDE_PIN
 #define MAGNITUDE_PIN 4
+#endif
 
 // magic numbers for mapping from antenna input
 #define PHASE_MIN 0.01
@@ -196,8 +280,14 @@ enum CHANNEL
 #if MODE == MODE_PINS
 
 // the wires are connected to these analog inputs
+// can be overriden via compilation flags
+// (both must be below the number of analog input channels)
+#ifndef PHASE_PIN
 #define PHASE_PIN 0
+#endif
+#ifndef MAGNITUDE_PIN
 #define MAGNITUDE_PIN 4
+#endif
 
 // magic numbers for mapping from wire input
 #define PHASE_MIN 0
@@ -245,6 +335,37 @@ enum CHANNEL
 
 //---------------------------------------------------------------------
 
+// control conditioning rate
+// the antenna signals are band limited to about 10 Hz
+// so they are read, filtered and mapped once every CONTROL_DECIMATION
+// audio frames, and held (or interpolated) to audio rate
+// #define CONTROL_DECIMATION 0 (the default) to condition once per analog frame
+// #define CONTROL_DECIMATION 1 for the legacy once per audio frame
+// must divide the block size
+#ifdef CONTROL_DECIMATION
+#define CONTROL_DECIMATION_DEFINED 1
+#else
+#define CONTROL_DECIMATION_DEFINED 0
+#define CONTROL_DECIMATION 0
+#endif
+
+// control interpolation
+// defaults to holding each conditioned value until the next
+// #define CONTROL_INTERPOLATE 1 to ramp linearly instead,
+// which is smoother but delays controls by one control frame
+#ifdef CONTROL_INTERPOLATE
+#define CONTROL_INTERPOLATE_DEFINED 1
+#else
+#define CONTROL_INTERPOLATE_DEFINED 0
+#define CONTROL_INTERPOLATE 0
+#endif
+
+// low pass filter cutoff for noise reduction
+// only used when CONTROL_LOP is not 0
+#define CONTROL_LOP_FREQUENCY 10
+
+//---------------------------------------------------------------------
+
 // composition status reporting
 // defaults to enabled
 // #define REPORT_STATUS 0 before including to disable
@@ -255,6 +376,32 @@ enum CHANNEL
 #define REPORT_STATUS 1
 #endif
 
+//---------------------------------------------------------------------
+
+// render profiling
+// defaults to disabled
+// #define PROFILE 1 before including to time each stage of each block
+// (control conditioning, composition render, scope, record, output)
+// and add the statistics to the status report
+#ifdef PROFILE
+#define PROFILE_DEFINED 1
+#else
+#define PROFILE_DEFINED 0
+#define PROFILE 0
+#endif
+
+#if PROFILE && ! REPORT_STATUS
+#error PROFILE needs REPORT_STATUS
+#endif
+
+//---------------------------------------------------------------------
+
+// maximum audio block size supported
+// the per-block buffers are allocated with this size
+#ifndef BLOCK_SIZE_MAX
+#define BLOCK_SIZE_MAX 2048
+#endif
+
 //---------------------------------------------------------------------
 // dependencies
 
@@ -262,8 +409,13 @@ enum CHANNEL
 #include <cstdlib>
 #include <cstring>
 #include <time.h>
+// for detecting the optional block rendering API
+#include <type_traits>
 // for the nothrow version of new (memory allocation and construction)
 #include <new>
+// for lock-free overrun counters
+#include <atomic>
+#include <stdint.h>
 
 #include <Bela.h>
 
@@ -272,13 +424,12 @@ enum CHANNEL
 #endif
 
 #if RECORD
-#include <libraries/Pipe/Pipe.h>
 #include <libraries/sndfile/sndfile.h>
+#include "ring.h"
 #endif
 
-#if CONTROL_NOTCH || CONTROL_LOP
+// for the sample rate (and the control filters)
 #include "dsp.h"
-#endif
 
 //---------------------------------------------------------------------
 // composition API, to be implemented by client code
@@ -289,12 +440,262 @@ bool COMPOSITION_setup(BelaContext *context, struct COMPOSITION *C);
 void COMPOSITION_render(BelaContext *context, struct COMPOSITION *C, int n, float out[2], const float in[2], const float magnitude, const float phase);
 void COMPOSITION_cleanup(BelaContext *context, struct COMPOSITION *C);
 
+// optional block rendering API, can be implemented instead of COMPOSITION_render:
+//
+// void COMPOSITION_renderBlock(BelaContext *context, struct COMPOSITION *C, unsigned int frames, float *out[2], const float *in[2], const float *magnitude, const float *phase);
+//
+// it is called once per audio block with deinterleaved audio buffers
+// and control buffers that have already been filtered and mapped
+// (each buffer has 'frames' items; 'out' is cleared to 0 beforehand).
+// its presence is detected at compile time;
+// when it is not defined, COMPOSITION_render is called once per frame.
+
+// detect COMPOSITION_renderBlock
+// (found by argument dependent lookup when the template is instantiated,
+// which happens at the REBUS macro at the end of the composition)
+template <typename COMPOSITION_T, typename = void>
+struct HAS_RENDER_BLOCK : std::false_type
+{
+};
+
+template <typename COMPOSITION_T>
+struct HAS_RENDER_BLOCK<COMPOSITION_T, decltype(COMPOSITION_renderBlock((BelaContext *) nullptr, (COMPOSITION_T *) nullptr, 0u, (float **) nullptr, (const float **) nullptr, (const float *) nullptr, (const float *) nullptr), void())> : std::true_type
+{
+};
+
+//---------------------------------------------------------------------
+// overrun accounting
+//
+// counters for things running out of time or buffer space,
+// registered during setup and incremented without locks
+// from the realtime audio thread (or any other thread):
+//
+// OVERRUN *tooSlow = REBUS_overrun("fft task too slow"); // in COMPOSITION_setup
+// REBUS_countOverrun(tooSlow); // when it happens
+//
+// totals are printed with the status report
+// and the times they happened are noted in the recording metadata
+
+#define OVERRUNS_MAX 16
+
+struct OVERRUN
+{
+	// description, printed in reports
+	const char *name;
+	// number of times it happened
+	std::atomic<uint32_t> count;
+};
+
+OVERRUN OVERRUN_counters[OVERRUNS_MAX];
+int OVERRUN_registered = 0;
+
+// register a counter (not realtime safe)
+// returns nullptr if there are too many counters,
+// which REBUS_countOverrun() ignores
+static inline OVERRUN *REBUS_overrun(const char *name)
+{
+	if (OVERRUN_registered >= OVERRUNS_MAX)
+	{
+		rt_printf("Too many overrun counters, not counting '%s'.\n", name);
+		return nullptr;
+	}
+	OVERRUN *o = &OVERRUN_counters[OVERRUN_registered++];
+	o->name = name;
+	o->count.store(0, std::memory_order_relaxed);
+	return o;
+}
+
+// count one overrun (realtime safe, lock free)
+static inline void REBUS_countOverrun(OVERRUN *o)
+{
+	if (o)
+	{
+		o->count.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
 //---------------------------------------------------------------------
 
 #if RECORD
 
-// RECORD_SIZE must be >= block size * channels
-#define RECORD_SIZE 65536
+// recording ring buffer size in frames
+// must be bigger than RECORD_BATCH_FRAMES plus the block size
+#ifndef RECORD_RING_FRAMES
+#define RECORD_RING_FRAMES 65536
+#endif
+
+// frames collected before the writer task is woken
+#ifndef RECORD_BATCH_FRAMES
+#define RECORD_BATCH_FRAMES 4096
+#endif
+
+// libsndfile format and filename extension for each RECORD_FORMAT
+static const int RECORD_sfFormat[4] =
+	{ SF_FORMAT_WAV | SF_FORMAT_FLOAT
+	, SF_FORMAT_WAV | SF_FORMAT_PCM_16
+	, SF_FORMAT_WAV | SF_FORMAT_PCM_24
+	, SF_FORMAT_FLAC | SF_FORMAT_PCM_24
+	};
+static const char *RECORD_extension[4] = { "wav", "wav", "wav", "flac" };
+
+// one recorded stream of sound files (the recording or the control sidecar)
+// the ring buffer is written by the realtime audio thread,
+// the rest is only used by the non-realtime writer (and setup and cleanup)
+struct RECORD_STREAM
+{
+	// interleaved frames, read in place by the writer
+	RING ring;
+
+	// current sound file handle
+	SNDFILE *file;
+
+	// sound file parameters
+	SF_INFO info;
+
+	// filename without segment number and extension
+	char name[960];
+	const char *extension;
+
+	// frames per segment (0 for a single file) and between syncs
+	sf_count_t segmentFrames;
+	sf_count_t syncFrames;
+
+	// current segment number, with frames written since it was opened
+	// and since the last sync
+	unsigned int segment;
+	sf_count_t written;
+	sf_count_t unsynced;
+
+	// overrun counts already noted, and notes for the current segment
+	// (stored as the file comment when the segment is closed)
+	uint32_t overruns[OVERRUNS_MAX];
+	char notes[4096];
+	size_t notesLength;
+};
+
+// note overruns since the last call at the current position (not realtime safe)
+static inline void RECORD_noteOverruns(RECORD_STREAM *R)
+{
+	for (int i = 0; i < OVERRUN_registered; ++i)
+	{
+		uint32_t count = OVERRUN_counters[i].count.load(std::memory_order_relaxed);
+		if (count != R->overruns[i])
+		{
+			if (R->notesLength < sizeof(R->notes))
+			{
+				int length = snprintf(&R->notes[R->notesLength], sizeof(R->notes) - R->notesLength,
+					"%.3fs %s +%u\n", R->written / (double) R->info.samplerate, OVERRUN_counters[i].name, count - R->overruns[i]);
+				if (length > 0)
+				{
+					R->notesLength += length;
+				}
+			}
+			R->overruns[i] = count;
+		}
+	}
+}
+
+// filename of a segment
+static inline void RECORD_path(char *path, size_t size, const RECORD_STREAM *R, unsigned int segment)
+{
+	if (R->segmentFrames > 0)
+	{
+		snprintf(path, size, "%s-%04u.%s", R->name, segment, R->extension);
+	}
+	else
+	{
+		snprintf(path, size, "%s.%s", R->name, R->extension);
+	}
+}
+
+// open the current segment (not realtime safe)
+static inline bool RECORD_open(RECORD_STREAM *R)
+{
+	char path[1024];
+	RECORD_path(path, sizeof(path), R, R->segment);
+	SF_INFO info = R->info;
+	if (! (R->file = sf_open(path, SFM_WRITE, &info)))
+	{
+		rt_printf("Could not open '%s' for recording.\n", path);
+		return false;
+	}
+
+	// clip instead of wrapping when converting to integer formats
+	sf_command(R->file, SFC_SET_CLIPPING, nullptr, SF_TRUE);
+	return true;
+}
+
+// finalize and close the current segment (not realtime safe)
+static inline void RECORD_close(RECORD_STREAM *R)
+{
+	if (R->file)
+	{
+		// WAV comments can be added after the audio data
+		if (R->notesLength > 0)
+		{
+			sf_set_string(R->file, SF_STR_COMMENT, R->notes);
+		}
+		sf_write_sync(R->file);
+		sf_close(R->file);
+		R->file = nullptr;
+	}
+	R->notes[0] = 0;
+	R->notesLength = 0;
+}
+
+// write everything available in the ring buffer to the sound files,
+// straight from the ring buffer memory,
+// syncing and starting new segments as needed (not realtime safe)
+static inline void RECORD_drain(RECORD_STREAM *R)
+{
+	const float *frames;
+	uint32_t count;
+	RECORD_noteOverruns(R);
+	while ((count = ring_readable(&R->ring, &frames)) > 0)
+	{
+		// split at segment boundaries
+		if (R->segmentFrames > 0 && count > R->segmentFrames - R->written)
+		{
+			count = R->segmentFrames - R->written;
+		}
+
+		// if the segment could not be opened, the data is discarded
+		if (R->file)
+		{
+			sf_writef_float(R->file, frames, count);
+		}
+		ring_release(&R->ring, count);
+		R->written += count;
+		R->unsynced += count;
+
+		// make the file readable up to here even after a crash
+		if (R->file && R->syncFrames > 0 && R->unsynced >= R->syncFrames)
+		{
+			sf_command(R->file, SFC_UPDATE_HEADER_NOW, nullptr, 0);
+			sf_write_sync(R->file);
+			R->unsynced = 0;
+		}
+
+		// roll over to the next segment
+		if (R->segmentFrames > 0 && R->written >= R->segmentFrames)
+		{
+			RECORD_close(R);
+			R->segment += 1;
+			R->written = 0;
+			R->unsynced = 0;
+#if RECORD_SEGMENTS_KEEP
+			// delete the oldest segment to bound storage
+			if (R->segment >= RECORD_SEGMENTS_KEEP)
+			{
+				char path[1024];
+				RECORD_path(path, sizeof(path), R, R->segment - RECORD_SEGMENTS_KEEP);
+				remove(path);
+			}
+#endif
+			RECORD_open(R);
+		}
+	}
+}
 
 // forward declare the non-realtime record task callback
 template <typename COMPOSITION_T>
@@ -304,6 +705,139 @@ void REBUS_record(void *);
 
 //---------------------------------------------------------------------
 
+#if PROFILE
+
+// render stages that are timed
+enum PROFILE_STAGE
+{
+	PROFILE_CONTROL = 0,
+	PROFILE_RENDER = 1,
+	PROFILE_SCOPE = 2,
+	PROFILE_RECORD = 3,
+	PROFILE_OUTPUT = 4,
+	PROFILE_TOTAL = 5,
+	PROFILE_STAGES = 6
+};
+
+const char *PROFILE_stageName[PROFILE_STAGES] =
+	{ "control", "render", "scope", "record", "output", "total" };
+
+// histogram bins are spaced 4 per octave of nanoseconds
+// from 64ns (bin 0) to 64ms (last bin), p99 is accurate to about 20%
+#define PROFILE_BINS_PER_OCTAVE 4
+#define PROFILE_OCTAVE_MIN 6
+#define PROFILE_OCTAVES 20
+#define PROFILE_BINS (PROFILE_OCTAVES * PROFILE_BINS_PER_OCTAVE)
+
+// timing statistics for one stage
+// only accessed by the realtime audio thread
+// (updated each block and read when reporting status)
+// so no locks or atomics are needed
+struct PROFILE_STATS
+{
+	uint64_t count;
+	uint64_t total;
+	uint32_t min;
+	uint32_t max;
+	uint32_t histogram[PROFILE_BINS];
+};
+
+// monotonic clock in nanoseconds
+// Xenomai's clock_gettime is realtime safe on Bela (no mode switch)
+static inline uint64_t PROFILE_now()
+{
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return uint64_t(t.tv_sec) * 1000000000u + t.tv_nsec;
+}
+
+// histogram bin for a time in nanoseconds
+static inline int PROFILE_bin(uint32_t ns)
+{
+	if (ns < (1u << PROFILE_OCTAVE_MIN))
+	{
+		return 0;
+	}
+	int octave = 31 - __builtin_clz(ns);
+	int fraction = (ns >> (octave - 2)) & 3; // 2 bits below the leading bit
+	int bin = (octave - PROFILE_OCTAVE_MIN) * PROFILE_BINS_PER_OCTAVE + fraction;
+	return bin < PROFILE_BINS ? bin : PROFILE_BINS - 1;
+}
+
+// upper edge of a histogram bin in nanoseconds
+static inline double PROFILE_binEdge(int bin)
+{
+	int octave = bin / PROFILE_BINS_PER_OCTAVE + PROFILE_OCTAVE_MIN;
+	int fraction = bin % PROFILE_BINS_PER_OCTAVE;
+	return std::ldexp(1 + (fraction + 1) / 4.0, octave);
+}
+
+static inline void PROFILE_reset(PROFILE_STATS *P)
+{
+	std::memset(P, 0, sizeof(*P));
+	P->min = ~0u;
+}
+
+static inline void PROFILE_add(PROFILE_STATS *P, uint64_t start, uint64_t end)
+{
+	uint32_t ns = end - start;
+	P->count += 1;
+	P->total += ns;
+	P->min = ns < P->min ? ns : P->min;
+	P->max = ns > P->max ? ns : P->max;
+	P->histogram[PROFILE_bin(ns)] += 1;
+}
+
+// upper bound of the percentile 'p' (in 0..100) in nanoseconds
+static inline double PROFILE_percentile(const PROFILE_STATS *P, double p)
+{
+	uint64_t target = std::ceil(P->count * p / 100);
+	uint64_t cumulative = 0;
+	for (int bin = 0; bin < PROFILE_BINS; ++bin)
+	{
+		cumulative += P->histogram[bin];
+		if (cumulative >= target)
+		{
+			// the bin edge may overestimate, the maximum is exact
+			return std::fmin(PROFILE_binEdge(bin), P->max);
+		}
+	}
+	return P->max;
+}
+
+// print statistics in microseconds,
+// with the mean and maximum as percentages of the block duration
+static inline void PROFILE_report(const PROFILE_STATS *P, const char *name, double blockNanoseconds)
+{
+	if (P->count == 0)
+	{
+		return;
+	}
+	double mean = P->total / (double) P->count;
+	rt_printf("  %-8s min %8.1f mean %8.1f p99 %8.1f max %8.1f us, mean %5.1f%% max %5.1f%% of block\n",
+		name, P->min / 1000.0, mean / 1000.0, PROFILE_percentile(P, 99) / 1000.0, P->max / 1000.0,
+		100 * mean / blockNanoseconds, 100 * P->max / blockNanoseconds);
+}
+
+#endif
+
+//---------------------------------------------------------------------
+
+// analog IO runs at half the audio rate with 8 channels,
+// the same rate with 4 channels, and double the rate with 2 channels
+// (the ratio as shifts, set by setup)
+unsigned int REBUS_analogShiftUp = 0;
+unsigned int REBUS_analogShiftDown = 0;
+
+// analog frame corresponding to audio frame 'n'
+// use this instead of hardcoding n/2 when reading analog inputs
+static inline unsigned int REBUS_analogFrame(BelaContext *context, unsigned int n)
+{
+	return (n << REBUS_analogShiftUp) >> REBUS_analogShiftDown;
+}
+
+//---------------------------------------------------------------------
+
 // state
 
 template <typename COMPOSITION_T>
@@ -315,34 +849,45 @@ struct STATE
 	// composition state
 	COMPOSITION_T composition;
 
+//---------------------------------------------------------------------
+
+	// per-block buffers, deinterleaved
+	// written by the render callback before the composition renders
+	float in[2][BLOCK_SIZE_MAX];
+	float magnitude[BLOCK_SIZE_MAX];
+	float phase[BLOCK_SIZE_MAX];
+	// written by the composition render
+	float out[2][BLOCK_SIZE_MAX];
+
 //---------------------------------------------------------------------
 
 #if RECORD
 
 	// recording state
 
-	// this interleaved buffer is written by
-	// the realtime audio thread
-	// during the render callback
-	float recordOut[RECORD_SIZE];
-
-	// this interleaved buffer is written by
-	// the non-realtime sound file writer task
-	// during the task callback
-	float recordIn[RECORD_SIZE];
+	// interleaved frames written by the realtime audio thread
+	// during the render callback, and written to sound files
+	// by the non-realtime sound file writer task
+	RECORD_STREAM record;
 
 	// the non-realtime sound file writer task
 	AuxiliaryTask recordTask;
 
-	// communication from realtime audio to non-realtime sound file writer
-	Pipe pipe;
+	// blocks dropped because the writer fell behind
+	OVERRUN *recordDropped;
 
-	// output sound file handle
-	SNDFILE *outFile;
+#if RECORD_CONTROL_DECIMATION
 
-	// the number of items stored in the recordOut buffer
-	// during each run of the realtime audio render callback
-	unsigned int items;
+	// decimated magnitude and phase
+	RECORD_STREAM control;
+
+	// audio frames until the next control frame is recorded
+	unsigned int controlCountdown;
+
+	// control frames dropped because the writer fell behind
+	OVERRUN *controlDropped;
+
+#endif
 
 #endif
 
@@ -355,12 +900,29 @@ struct STATE
 
 #endif
 
+//---------------------------------------------------------------------
+
+	// audio frames per control frame
+	unsigned int controlDecimation;
+
+#if CONTROL_INTERPOLATE
+
+	// previous conditioned control values
+	float previousPhase;
+	float previousMagnitude;
+
+#endif
+
 //---------------------------------------------------------------------
 
 #if CONTROL_NOTCH
 
-	// notch filter state
-	BIQUAD notch[2];
+	// notch filter coefficients, shared by phase and magnitude,
+	// designed at the control rate
+	// (double precision: the notch is narrow and at a low frequency)
+	BIQUAD_COEFFS_DOUBLE notch;
+	// notch filter state for phase and magnitude
+	BIQUAD_STATE_DOUBLE notchState[2];
 
 #endif
 
@@ -371,6 +933,9 @@ struct STATE
 	// low pass filter state
 	LOP lop[2];
 
+	// low pass filter coefficient at the control rate
+	double lopCoefficient;
+
 #endif
 
 //---------------------------------------------------------------------
@@ -383,6 +948,21 @@ struct STATE
 	// counts elapsed
 	int blocksElapsed;
 
+	// overrun counts already reported
+	uint32_t overrunsReported[OVERRUNS_MAX];
+
+#endif
+
+//---------------------------------------------------------------------
+
+#if PROFILE
+
+	// timing statistics for each render stage
+	PROFILE_STATS profile[PROFILE_STAGES];
+
+	// duration of one block (the deadline)
+	double blockNanoseconds;
+
 #endif
 
 //---------------------------------------------------------------------
@@ -406,42 +986,107 @@ bool REBUS_setup(BelaContext *context, void *userData)
 	}
 	STATE_ptr = S;
 
+	// check the per-block buffers are big enough
+	if (context->audioFrames > BLOCK_SIZE_MAX)
+	{
+		rt_printf("Block size %d is too big, maximum is %d.\n", (int) context->audioFrames, (int) BLOCK_SIZE_MAX);
+		return false;
+	}
+
+	// set the sample rate for dsp.h
+	if (! rate_setup(context->audioSampleRate))
+	{
+		// only possible with a compile-time SR
+		rt_printf("Sample rate mismatch: using %f, expected %f.\n", (double) context->audioSampleRate, rate().sr);
+		// pitch and tempo will not be as intended, but carry on
+	}
+
 //---------------------------------------------------------------------
 
 #if RECORD
 
 	// output audio file parameters
-	SF_INFO info = {0};
-	info.channels = RECORD_CHANNELS;
-	info.samplerate = context->audioSampleRate;
-	info.format = SF_FORMAT_WAV | SF_FORMAT_FLOAT;
+	S->record.info.channels = RECORD_CHANNELS;
+	S->record.info.samplerate = context->audioSampleRate;
+	S->record.info.format = RECORD_sfFormat[RECORD_FORMAT];
+	S->record.extension = RECORD_extension[RECORD_FORMAT];
+	S->record.segmentFrames = sf_count_t(RECORD_SEGMENT_SECONDS) * S->record.info.samplerate;
+	S->record.syncFrames = sf_count_t(RECORD_SYNC_SECONDS) * S->record.info.samplerate;
+
+#if RECORD_CONTROL_DECIMATION
+	// sound files have whole sample rates, so the control sidecar stays
+	// in time with the audio only if the decimation divides the audio rate
+	if (S->record.info.samplerate % RECORD_CONTROL_DECIMATION != 0)
+	{
+		rt_printf("Record control decimation %d does not divide sample rate %d.\n", (int) RECORD_CONTROL_DECIMATION, (int) S->record.info.samplerate);
+		return false;
+	}
+#endif
 
 	// create a filename based on the current date and time
 	// with the composition name appended
-	char recordPath[1000];
 	time_t secondsSinceEpoch = time(0);
 	struct tm *t = localtime(&secondsSinceEpoch);
 	if (t)
 	{
 		// human-readable datetime format
-		snprintf(recordPath, sizeof(recordPath), "%04d-%02d-%02d-%02d-%02d-%02d-%s.wav", 1900 + t->tm_year, t->tm_mon + 1, t->tm_mday, t->tm_hour, t->tm_min, t->tm_sec, COMPOSITION_name);
+		snprintf(S->record.name, sizeof(S->record.name), "%04d-%02d-%02d-%02d-%02d-%02d-%s", 1900 + t->tm_year, t->tm_mon + 1, t->tm_mday, t->tm_hour, t->tm_min, t->tm_sec, COMPOSITION_name);
 	}
 	else
 	{
 		// cryptically-named fallback in case the localtime() function fails
-		snprintf(recordPath, sizeof(recordPath), "%08x-%s.wav", (unsigned int) secondsSinceEpoch, COMPOSITION_name);
+		snprintf(S->record.name, sizeof(S->record.name), "%08x-%s", (unsigned int) secondsSinceEpoch, COMPOSITION_name);
 	}
+	char recordPath[1024];
+	RECORD_path(recordPath, sizeof(recordPath), &S->record, 0);
 
 	// open the output sound file
-	if (! (S->outFile = sf_open(recordPath, SFM_WRITE, &info)))
+	if (! RECORD_open(&S->record))
 	{
-		rt_printf("Could not open '%s' for recording.\n", recordPath);
 		return false; // FIXME should this be a hard failure?
 	}
 
-	// create the pipe to communicate the record
+	// create the ring buffer to communicate the record
 	// from realtime audio to non-realtime writer
-	S->pipe.setup("record-pipe", 65536, false, false);
+	if (RECORD_RING_FRAMES < RECORD_BATCH_FRAMES + context->audioFrames || ! ring_setup(&S->record.ring, RECORD_RING_FRAMES, RECORD_CHANNELS))
+	{
+		rt_printf("Could not create recorder ring buffer.\n");
+		return false;
+	}
+
+#if RECORD_CONTROL_DECIMATION
+
+	// control sidecar sound file parameters
+	S->control.info.channels = 2;
+	S->control.info.samplerate = S->record.info.samplerate / RECORD_CONTROL_DECIMATION;
+	S->control.info.format = SF_FORMAT_WAV | SF_FORMAT_FLOAT;
+	S->control.extension = "wav";
+	// segments and syncs at the same times as the audio
+	S->control.segmentFrames = S->record.segmentFrames / RECORD_CONTROL_DECIMATION;
+	S->control.syncFrames = S->record.syncFrames / RECORD_CONTROL_DECIMATION;
+	snprintf(S->control.name, sizeof(S->control.name), "%.900s-control", S->record.name);
+	char controlPath[1024];
+	RECORD_path(controlPath, sizeof(controlPath), &S->control, 0);
+
+	// open the control sidecar sound file
+	if (! RECORD_open(&S->control))
+	{
+		return false; // FIXME should this be a hard failure?
+	}
+	if (! ring_setup(&S->control.ring, RECORD_RING_FRAMES / RECORD_CONTROL_DECIMATION + context->audioFrames, S->control.info.channels))
+	{
+		rt_printf("Could not create recorder ring buffer.\n");
+		return false;
+	}
+	S->controlCountdown = 0;
+
+	// count control frames that do not fit in the ring buffer
+	S->controlDropped = REBUS_overrun("recording dropped control frame");
+
+#endif
+
+	// count blocks that do not fit in the ring buffer
+	S->recordDropped = REBUS_overrun("recording dropped block");
 
 	// create the non-realtime sound file writer task
 	if (! (S->recordTask = Bela_createAuxiliaryTask(&REBUS_record<COMPOSITION_T>, 90, "record")))
@@ -449,7 +1094,6 @@ bool REBUS_setup(BelaContext *context, void *userData)
 		rt_printf("Could not create recorder task.\n");
 		return false; // FIXME should this be a hard failure?
 	}
-	S->items = context->audioFrames * info.channels;
 
 #endif
 
@@ -462,16 +1106,75 @@ bool REBUS_setup(BelaContext *context, void *userData)
 
 #endif
 
+//---------------------------------------------------------------------
+
+	// check the control pins are available
+	if (context->analogFrames == 0 || context->analogInChannels <= (PHASE_PIN > MAGNITUDE_PIN ? PHASE_PIN : MAGNITUDE_PIN))
+	{
+		rt_printf("Need analog input pins %d and %d, but only %d analog input channels are enabled.\n",
+			(int) PHASE_PIN, (int) MAGNITUDE_PIN, (int) context->analogInChannels);
+		return false;
+	}
+
+	// the ratio of analog to audio frames is a power of two
+	REBUS_analogShiftUp = 0;
+	REBUS_analogShiftDown = 0;
+	while ((context->audioFrames << REBUS_analogShiftUp) < context->analogFrames)
+	{
+		++REBUS_analogShiftUp;
+	}
+	while ((context->analogFrames << REBUS_analogShiftDown) < context->audioFrames)
+	{
+		++REBUS_analogShiftDown;
+	}
+	if ((context->audioFrames << REBUS_analogShiftUp) >> REBUS_analogShiftDown != context->analogFrames)
+	{
+		rt_printf("Analog frames %d per block of %d audio frames is not a power of two ratio.\n",
+			(int) context->analogFrames, (int) context->audioFrames);
+		return false;
+	}
+
+	// by default, condition controls once per analog frame
+	// (or once per audio frame if analog IO runs faster than audio)
+	unsigned int audioFramesPerAnalogFrame = context->audioFrames / context->analogFrames;
+	if (audioFramesPerAnalogFrame < 1)
+	{
+		audioFramesPerAnalogFrame = 1;
+	}
+	S->controlDecimation = CONTROL_DECIMATION > 0 ? CONTROL_DECIMATION : audioFramesPerAnalogFrame;
+	if (context->audioFrames % S->controlDecimation != 0)
+	{
+		rt_printf("Control decimation %d does not divide block size %d.\n", (int) S->controlDecimation, (int) context->audioFrames);
+		return false;
+	}
+#if CONTROL_NOTCH || CONTROL_LOP
+	const double controlRate = context->audioSampleRate / S->controlDecimation;
+#endif
+
+#if CONTROL_INTERPOLATE
+
+	// start from 0
+	S->previousPhase = 0;
+	S->previousMagnitude = 0;
+
+#endif
+
 //---------------------------------------------------------------------
 
 #if CONTROL_NOTCH
 
+	// the notch must be below the control rate Nyquist frequency
+	if (2 * MAINS_HUM_FREQUENCY >= controlRate)
+	{
+		rt_printf("Control rate %f Hz is too low for notch filter at %f Hz.\n", controlRate, (double) MAINS_HUM_FREQUENCY);
+		return false;
+	}
+
 	// clear filter state to 0
-	std::memset(&S->notch, 0, sizeof(S->notch));
+	std::memset(&S->notchState, 0, sizeof(S->notchState));
 
-	// compute biquad filter coefficients
-	notch(&S->notch[0], MAINS_HUM_FREQUENCY, MAINS_HUM_QFACTOR);
-	notch(&S->notch[1], MAINS_HUM_FREQUENCY, MAINS_HUM_QFACTOR);
+	// compute biquad filter coefficients for the control rate
+	notch(&S->notch, MAINS_HUM_FREQUENCY, MAINS_HUM_QFACTOR, rate_constant(controlRate));
 
 #endif
 
@@ -482,6 +1185,9 @@ bool REBUS_setup(BelaContext *context, void *userData)
 	// clear filter state to 0
 	std::memset(&S->lop, 0, sizeof(S->lop));
 
+	// compute the coefficient once, as lop() does every call
+	S->lopCoefficient = clamp(2 * M_PI * CONTROL_LOP_FREQUENCY / controlRate, 0, 1);
+
 #endif
 
 //---------------------------------------------------------------------
@@ -495,6 +1201,19 @@ bool REBUS_setup(BelaContext *context, void *userData)
 
 #endif
 
+//---------------------------------------------------------------------
+
+#if PROFILE
+
+	// clear statistics
+	for (int stage = 0; stage < PROFILE_STAGES; ++stage)
+	{
+		PROFILE_reset(&S->profile[stage]);
+	}
+	S->blockNanoseconds = 1.0e9 * context->audioFrames / context->audioSampleRate;
+
+#endif
+
 //---------------------------------------------------------------------
 
 	// composition setup
@@ -515,6 +1234,9 @@ bool REBUS_setup(BelaContext *context, void *userData)
 #endif
 			"\n"
 		, recordPath);
+#if RECORD_CONTROL_DECIMATION
+		rt_printf("Recording controls every %d frames to '%s'.\n", (int) RECORD_CONTROL_DECIMATION, controlPath);
+#endif
 #else
 		rt_printf(
 			"Recording disabled."
@@ -544,12 +1266,19 @@ bool REBUS_setup(BelaContext *context, void *userData)
 		);
 #endif
 
+		// print messages about the state of profiling
+#if PROFILE
+		rt_printf("Profiling enabled, statistics are reported with status.\n");
+#endif
+
 		// print messages about the state of control filtering
+		rt_printf("Conditioning controls every %d audio frames%s.\n", (int) S->controlDecimation,
+			CONTROL_INTERPOLATE ? " with interpolation" : "");
 #if CONTROL_NOTCH
 		rt_printf("Using notch filter at %f Hz, Q %f to reduce mains hum.\n", (double) MAINS_HUM_FREQUENCY, (double) MAINS_HUM_QFACTOR);
 #endif
 #if CONTROL_LOP
-		rt_printf("Using low pass filter at %f Hz to reduce noise.\n", (double) 10);
+		rt_printf("Using low pass filter at %f Hz to reduce noise.\n", (double) CONTROL_LOP_FREQUENCY);
 #endif
 
 	}
@@ -560,6 +1289,35 @@ bool REBUS_setup(BelaContext *context, void *userData)
 	return ok;
 }
 
+//---------------------------------------------------------------------
+// composition render, one call per frame
+
+template <typename COMPOSITION_T>
+inline void REBUS_renderComposition(BelaContext *context, STATE<COMPOSITION_T> *S, std::false_type)
+{
+	for (unsigned int n = 0; n < context->audioFrames; ++n)
+	{
+		float in[2] = { S->in[0][n], S->in[1][n] };
+		float out[2] = { 0.0f, 0.0f };
+		COMPOSITION_render(context, &S->composition, n, out, in, S->magnitude[n], S->phase[n]);
+		S->out[0][n] = out[0];
+		S->out[1][n] = out[1];
+	}
+}
+
+//---------------------------------------------------------------------
+// composition render, one call per block
+
+template <typename COMPOSITION_T>
+inline void REBUS_renderComposition(BelaContext *context, STATE<COMPOSITION_T> *S, std::true_type)
+{
+	std::memset(&S->out[0][0], 0, sizeof(S->out[0][0]) * context->audioFrames);
+	std::memset(&S->out[1][0], 0, sizeof(S->out[1][0]) * context->audioFrames);
+	float *out[2] = { &S->out[0][0], &S->out[1][0] };
+	const float *in[2] = { &S->in[0][0], &S->in[1][0] };
+	COMPOSITION_renderBlock(context, &S->composition, context->audioFrames, out, in, &S->magnitude[0], &S->phase[0]);
+}
+
 //---------------------------------------------------------------------
 // render
 
@@ -567,15 +1325,26 @@ template <typename COMPOSITION_T>
 void REBUS_render(BelaContext *context, void *userData)
 {
 	STATE<COMPOSITION_T> *S = (STATE<COMPOSITION_T> *) STATE_ptr;
+
+#if PROFILE
+	// timestamps at the start of each stage and the end
+	uint64_t timestamp[PROFILE_TOTAL + 1];
+	timestamp[PROFILE_CONTROL] = PROFILE_now();
+#endif
+
 	for (unsigned int n = 0; n < context->audioFrames; ++n)
 	{
 		// get audio inputs
-		float in[2] = { 0.0f, 0.0f };
-		in[0] = audioRead(context, n, 0);
-		in[1] = audioRead(context, n, 1);
+		S->in[0][n] = audioRead(context, n, 0);
+		S->in[1][n] = audioRead(context, n, 1);
+	}
 
+	// condition controls once per control frame
+	const unsigned int decimation = S->controlDecimation;
+	for (unsigned int n = 0; n < context->audioFrames; n += decimation)
+	{
 		// get controls from analog IO pins
-		unsigned int m = n / 2; // FIXME depends on analog IO sample rate
+		unsigned int m = REBUS_analogFrame(context, n);
 		const float rawPhase = analogRead(context, m, PHASE_PIN);
 		const float rawMagnitude = analogRead(context, m, MAGNITUDE_PIN);
 
@@ -584,14 +1353,15 @@ void REBUS_render(BelaContext *context, void *userData)
 
 #if CONTROL_NOTCH
 		// try to remove mains hum using a biquad notch filter
-		phase = biquad(&S->notch[0], phase);
-		magnitude = biquad(&S->notch[1], magnitude);
+		phase = biquad(&S->notch, &S->notchState[0], phase);
+		magnitude = biquad(&S->notch, &S->notchState[1], magnitude);
 #endif
 
 #if CONTROL_LOP
-		// try to remove noise using a low pass filter at 10 Hz
-		phase = lop(&S->lop[0], phase, 10);
-		magnitude = lop(&S->lop[1], magnitude, 10);
+		// try to remove noise using a low pass filter
+		const double c = S->lopCoefficient;
+		phase = S->lop[0].y = mix(phase, S->lop[0].y, 1 - c);
+		magnitude = S->lop[1].y = mix(magnitude, S->lop[1].y, 1 - c);
 #endif
 
 		// map to 0..1 range (FIXME remove this:
@@ -601,23 +1371,49 @@ void REBUS_render(BelaContext *context, void *userData)
 		phase = map(phase, PHASE_MIN, PHASE_MAX, 0, 1);
 		magnitude = map(magnitude, MAGNITUDE_MIN, MAGNITUDE_MAX, 0, 1);
 
-		// render
-		float out[2] = { 0.0f, 0.0f };
+#if CONTROL_INTERPOLATE
+		// ramp from the previous control frame
+		const float dPhase = (phase - S->previousPhase) / decimation;
+		const float dMagnitude = (magnitude - S->previousMagnitude) / decimation;
+		for (unsigned int k = 0; k < decimation; ++k)
+		{
+			S->phase[n + k] = S->previousPhase + dPhase * (k + 1);
+			S->magnitude[n + k] = S->previousMagnitude + dMagnitude * (k + 1);
+		}
+		S->previousPhase = phase;
+		S->previousMagnitude = magnitude;
+#else
+		// hold until the next control frame
+		for (unsigned int k = 0; k < decimation; ++k)
+		{
+			S->phase[n + k] = phase;
+			S->magnitude[n + k] = magnitude;
+		}
+#endif
+	}
+
+#if PROFILE
+	timestamp[PROFILE_RENDER] = PROFILE_now();
+#endif
 
 //---------------------------------------------------------------------
 // composition render
-		COMPOSITION_render(context, &S->composition, n, out, in, magnitude, phase);
+	REBUS_renderComposition(context, S, HAS_RENDER_BLOCK<COMPOSITION_T>());
 //---------------------------------------------------------------------
 
-		// output
-		// compile-time conditionals avoid wasted per-sample work
-
-#if SCOPE || RECORD
-		// store available channels for permuation below
-		float channels[6] = { magnitude, phase, out[0], out[1], in[0], in[1] };
+#if PROFILE
+	timestamp[PROFILE_SCOPE] = PROFILE_now();
 #endif
 
+	// output
+	// compile-time conditionals avoid wasted per-sample work
+
 #if SCOPE
+	for (unsigned int n = 0; n < context->audioFrames; ++n)
+	{
+		// store available channels for permuation below
+		float channels[6] = { S->magnitude[n], S->phase[n], S->out[0][n], S->out[1][n], S->in[0][n], S->in[1][n] };
+
 		// write data to oscilloscope
 		float scope_data[SCOPE_CHANNELS];
 #if SCOPE_CHANNELS > 0
@@ -639,39 +1435,97 @@ void REBUS_render(BelaContext *context, void *userData)
 		scope_data[5] = channels[CHANNEL::SCOPE_CHANNEL_6];
 #endif
 		S->scope.log(scope_data);
+	}
+#endif
+
+#if PROFILE
+	timestamp[PROFILE_RECORD] = PROFILE_now();
 #endif
 
 #if RECORD
-		// write data to interleaved buffer
+	// write data directly into the ring buffer
+	// if the writer has fallen behind, the block is dropped
+	if (ring_writable(&S->record.ring) >= context->audioFrames)
+	{
+		for (unsigned int n = 0; n < context->audioFrames; ++n)
+		{
+			// store available channels for permuation below
+			float channels[6] = { S->magnitude[n], S->phase[n], S->out[0][n], S->out[1][n], S->in[0][n], S->in[1][n] };
+
+			// write data to interleaved ring slot
+			float *recordOut = ring_frame(&S->record.ring, n);
 #if RECORD_CHANNELS > 0
-		S->recordOut[RECORD_CHANNELS * n + 0] = channels[CHANNEL::RECORD_CHANNEL_1];
+			recordOut[0] = channels[CHANNEL::RECORD_CHANNEL_1];
 #endif
 #if RECORD_CHANNELS > 1
-		S->recordOut[RECORD_CHANNELS * n + 1] = channels[CHANNEL::RECORD_CHANNEL_2];
+			recordOut[1] = channels[CHANNEL::RECORD_CHANNEL_2];
 #endif
 #if RECORD_CHANNELS > 2
-		S->recordOut[RECORD_CHANNELS * n + 2] = channels[CHANNEL::RECORD_CHANNEL_3];
+			recordOut[2] = channels[CHANNEL::RECORD_CHANNEL_3];
 #endif
 #if RECORD_CHANNELS > 3
-		S->recordOut[RECORD_CHANNELS * n + 3] = channels[CHANNEL::RECORD_CHANNEL_4];
+			recordOut[3] = channels[CHANNEL::RECORD_CHANNEL_4];
 #endif
 #if RECORD_CHANNELS > 4
-		S->recordOut[RECORD_CHANNELS * n + 4] = channels[CHANNEL::RECORD_CHANNEL_5];
+			recordOut[4] = channels[CHANNEL::RECORD_CHANNEL_5];
 #endif
 #if RECORD_CHANNELS > 5
-		S->recordOut[RECORD_CHANNELS * n + 5] = channels[CHANNEL::RECORD_CHANNEL_6];
+			recordOut[5] = channels[CHANNEL::RECORD_CHANNEL_6];
+#endif
+		}
+		ring_commit(&S->record.ring, context->audioFrames);
+	}
+	else
+	{
+		REBUS_countOverrun(S->recordDropped);
+	}
+
+	// wake the non-realtime audio file writer when a batch is ready
+	if (ring_pending(&S->record.ring) >= RECORD_BATCH_FRAMES)
+	{
+		Bela_scheduleAuxiliaryTask(S->recordTask);
+	}
+
+#if RECORD_CONTROL_DECIMATION
+	// write decimated controls into the sidecar ring buffer
+	// (drained by the same writer task)
+	unsigned int m = S->controlCountdown;
+	for (; m < context->audioFrames; m += RECORD_CONTROL_DECIMATION)
+	{
+		if (ring_writable(&S->control.ring) > 0)
+		{
+			float *controlOut = ring_frame(&S->control.ring, 0);
+			controlOut[0] = S->magnitude[m];
+			controlOut[1] = S->phase[m];
+			ring_commit(&S->control.ring, 1);
+		}
+		else
+		{
+			REBUS_countOverrun(S->controlDropped);
+		}
+	}
+	S->controlCountdown = m - context->audioFrames;
 #endif
 #endif
 
+#if PROFILE
+	timestamp[PROFILE_OUTPUT] = PROFILE_now();
+#endif
+
+	for (unsigned int n = 0; n < context->audioFrames; ++n)
+	{
 		// write audio output
-		audioWrite(context, n, 0, out[0]);
-		audioWrite(context, n, 1, out[1]);
+		audioWrite(context, n, 0, S->out[0][n]);
+		audioWrite(context, n, 1, S->out[1][n]);
 	}
 
-#if RECORD
-	// send data to non-realtime audio file writer
-	S->pipe.writeRt(&S->recordOut[0], S->items);
-	Bela_scheduleAuxiliaryTask(S->recordTask);
+#if PROFILE
+	timestamp[PROFILE_TOTAL] = PROFILE_now();
+	for (int stage = 0; stage < PROFILE_TOTAL; ++stage)
+	{
+		PROFILE_add(&S->profile[stage], timestamp[stage], timestamp[stage + 1]);
+	}
+	PROFILE_add(&S->profile[PROFILE_TOTAL], timestamp[PROFILE_CONTROL], timestamp[PROFILE_TOTAL]);
 #endif
 
 #if REPORT_STATUS
@@ -679,6 +1533,25 @@ void REBUS_render(BelaContext *context, void *userData)
 	if (++(S->blocksElapsed) >= S->blocksPerReport)
 	{
 		rt_printf("Composition '%s' is still running.\n", COMPOSITION_name);
+		// report overruns, with the number since the last report
+		for (int i = 0; i < OVERRUN_registered; ++i)
+		{
+			uint32_t count = OVERRUN_counters[i].count.load(std::memory_order_relaxed);
+			if (count)
+			{
+				rt_printf("Overrun '%s' %u times (%u since last report).\n", OVERRUN_counters[i].name, count, count - S->overrunsReported[i]);
+			}
+			S->overrunsReported[i] = count;
+		}
+#if PROFILE
+		// report timing statistics since the last report, then start again
+		rt_printf("Render profile over %d blocks of %.1f us:\n", S->blocksElapsed, S->blockNanoseconds / 1000);
+		for (int stage = 0; stage < PROFILE_STAGES; ++stage)
+		{
+			PROFILE_report(&S->profile[stage], PROFILE_stageName[stage], S->blockNanoseconds);
+			PROFILE_reset(&S->profile[stage]);
+		}
+#endif
 		S->blocksElapsed = 0;
 	}
 #endif
@@ -689,18 +1562,23 @@ void REBUS_render(BelaContext *context, void *userData)
 // recording task
 
 #if RECORD
+// write all interleaved data from the realtime audio thread
+// to the recording sound files
+template <typename COMPOSITION_T>
+void REBUS_recordDrain(STATE<COMPOSITION_T> *S)
+{
+	RECORD_drain(&S->record);
+#if RECORD_CONTROL_DECIMATION
+	RECORD_drain(&S->control);
+#endif
+}
+
 template <typename COMPOSITION_T>
 void REBUS_record(void *)
 {
 	// cast to a pointer to the actual type of the structure in memory
 	STATE<COMPOSITION_T> *S = (STATE<COMPOSITION_T> *) STATE_ptr;
-	int ret;
-	// receive interleaved data from the realtime audio thread...
-	while (S->items && (ret = S->pipe.readNonRt(&S->recordIn[0], S->items)) > 0 && S->outFile)
-	{
-		// ...and write it to the recording sound file
-		sf_write_float(S->outFile, &S->recordIn[0], ret);
-	}
+	REBUS_recordDrain(S);
 }
 #endif
 
@@ -716,12 +1594,17 @@ void REBUS_cleanup(BelaContext *context, void *userData)
 
 #if RECORD
 		// finish the recording
-		if (S->outFile)
+		// the audio thread has stopped, write what is left
+		if (S->record.ring.data)
 		{
-			sf_write_sync(S->outFile);
-			sf_close(S->outFile);
-			S->outFile = nullptr;
+			REBUS_recordDrain(S);
 		}
+		RECORD_close(&S->record);
+		ring_cleanup(&S->record.ring);
+#if RECORD_CONTROL_DECIMATION
+		RECORD_close(&S->control);
+		ring_cleanup(&S->control.ring);
+#endif
 #endif
 
 //---------------------------------------------------------------------
@@ -729,6 +1612,10 @@ void REBUS_cleanup(BelaContext *context, void *userData)
 		COMPOSITION_cleanup(context, &S->composition);
 //---------------------------------------------------------------------
 
+		// the recorders are closed, so the counters can be registered again
+		// by the next setup
+		OVERRUN_registered = 0;
+
 		// free memory
 		delete S;
 		S = nullptr;
@@ -7,6 +7,10 @@
 // added more documentation 2025-12-10
 // removed pi/twopi 2026-03-07 (use M_PI instead)
 
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
 //---------------------------------------------------------------------
 // common definitions
 //---------------------------------------------------------------------
@@ -15,11 +19,73 @@
 // Change 'float' to 'double' if more precision is needed.
 typedef float sample;
 
-// Audio sample rate defined at compile time.
-// Should match 'context->audioSampleRate' defined at runtime,
+// Audio sample rate.
+// The functions below read it from a RATE structure,
+// which also holds reciprocals and other constants derived from it,
+// so they cost no divisions per sample.
+// By default the rate is set at runtime by rate_setup()
+// (REBUS_setup calls it with 'context->audioSampleRate'
+// before COMPOSITION_setup), so the same code runs in tune
+// at 22050 Hz, 44100 Hz, 48000 Hz, ...
+// Defining SR before including dsp.h (for example '#define SR 44100')
+// fixes the rate at compile time instead, so that the constants
+// fold into the code; then 'context->audioSampleRate' must match SR,
 // otherwise everything will be out of tune.
-#ifndef SR
-#define SR 44100
+typedef struct {
+  double sr; // samples per second
+  double isr; // seconds per sample
+  double spms; // samples per millisecond
+  double w; // radians per sample at 1 Hz (2 pi / sr)
+  double pinc; // 32bit phase increment per sample at 1 Hz (2^32 / sr)
+  float isrf, spmsf, wf, pincf; // single precision copies
+} RATE;
+
+// The constants for sample rate 'sr' (usable at compile time).
+static constexpr RATE rate_constant(double sr) {
+  return RATE{ sr, 1 / sr, sr / 1000, 2*M_PI / sr, 4294967296.0 / sr,
+    float(1 / sr), float(sr / 1000), float(2*M_PI / sr), float(4294967296.0 / sr) };
+}
+
+// Largest sample rate expected, for sizing buffers at compile time
+// (for example DELAY1s below).
+#ifndef SR_MAX
+#ifdef SR
+#define SR_MAX SR
+#else
+#define SR_MAX 48000
+#endif
+#endif
+
+#ifdef SR
+
+// The sample rate, fixed at compile time.
+static constexpr RATE rate_fixed = rate_constant(SR);
+static constexpr const RATE &rate() { return rate_fixed; }
+
+// Check the runtime sample rate 'sr' against SR.
+static inline bool rate_setup(double sr) {
+  return sr == SR;
+}
+
+#else
+
+// The sample rate, set at runtime (44100 until rate_setup() is called).
+// Not static, so there is one rate shared by every translation unit.
+inline RATE *rate_current() {
+  static RATE r = rate_constant(44100);
+  return &r;
+}
+static inline const RATE &rate() { return *rate_current(); }
+
+// Set the sample rate to 'sr'.
+// Not realtime safe with respect to the dsp functions:
+// call it before designing filters or starting audio.
+static inline bool rate_setup(double sr) {
+  if (! (sr > 0)) { return false; }
+  *rate_current() = rate_constant(sr);
+  return true;
+}
+
 #endif
 
 //---------------------------------------------------------------------
@@ -59,6 +125,10 @@ static inline sample trisaw(sample x, sample t) {
 }
 
 // Uniformly distributed white noise in the range -1 to +1.
+// Uses the C library rand(), which has hidden global state
+// and may take a lock: not realtime safe, and not reproducible
+// when several voices (or threads) share it.
+// Prefer rng_uniform() below.
 static inline sample noise() {
   return 2 * (rand() / (sample) RAND_MAX - (sample)0.5);
 }
@@ -66,6 +136,8 @@ static inline sample noise() {
 // Logarithmic remapping functions
 // based on implementations of Pure-data,
 // pd-0.45-5/src/d_math.c
+// (dsp_simd.h has vectorised and block versions,
+// faster when converting many values at once)
 
 #define log10overten 0.23025850929940458 // log(10)/10
 #define tenoverlog10 4.3429448190325175 // 10/log(10)
@@ -112,6 +184,126 @@ static inline sample bitcrush(sample x, sample bits) {
   return round(x * n) / n;
 }
 
+//---------------------------------------------------------------------
+// random numbers
+
+// Pseudo-random number generator state (xoshiro128+),
+// one per voice (or thread) for realtime safe, reproducible noise:
+// the same seed gives the same sequence on every run.
+// https://prng.di.unimi.it/
+// (dsp_simd.h has 4 and 8 lane versions with block fills)
+typedef struct { uint32_t s[4]; } RNG;
+
+// Seed the generator ('seed' may be any value, including 0).
+// Expands the seed with splitmix64 so that similar seeds
+// give unrelated sequences.
+static inline void rng_seed(RNG *r, uint64_t seed) {
+  for (int i = 0; i < 4; i += 2) {
+    uint64_t z = (seed += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    z ^= z >> 31;
+    r->s[i] = z;
+    r->s[i + 1] = z >> 32;
+  }
+}
+
+// Next 32 random bits (the low bits are weaker than the high bits).
+static inline uint32_t rng_next(RNG *r) {
+  uint32_t *s = r->s;
+  uint32_t result = s[0] + s[3];
+  uint32_t t = s[1] << 9;
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = (s[3] << 11) | (s[3] >> 21);
+  return result;
+}
+
+// Uniformly distributed white noise in the range -1 (inclusive) to +1.
+static inline sample rng_uniform(RNG *r) {
+  return (int32_t) rng_next(r) * (sample)4.656612873077392578125e-10; // 2^-31
+}
+
+// Uniformly distributed integer in the range 0 (inclusive) to 'n'.
+static inline uint32_t rng_below(RNG *r, uint32_t n) {
+  return ((uint64_t) rng_next(r) * n) >> 32;
+}
+
+// Normally distributed white noise
+// with mean 0 and standard deviation 1 (Box-Muller transform).
+static inline sample rng_gaussian(RNG *r) {
+  sample u = ((rng_next(r) >> 8) + 1) * (sample)5.9604644775390625e-8; // 0 < u <= 1
+  sample v = rng_uniform(r);
+  return sqrt(-2 * log(u)) * cos((sample)M_PI * v);
+}
+
+//---------------------------------------------------------------------
+// saturation
+//---------------------------------------------------------------------
+
+// Soft clipping and waveshaping, much cheaper than libm tanh / sin
+// (no library calls, bounded error, measured by host/dsp-bench).
+// Outputs are bounded to -1 to +1.
+// dsp_simd.h has vectorised and block versions.
+
+// Hyperbolic tangent, as a rational minimax approximation (from Eigen),
+// maximum absolute error 3.0e-7 (libm tanhf: 1.0e-7).
+static inline sample fasttanh(sample x) {
+  // (comparisons rather than clamp(), whose fmin / fmax may be library calls)
+  const sample limit = (sample)7.90531110763549805;
+  x = x < -limit ? -limit : x > limit ? limit : x;
+  sample x2 = x * x;
+  sample p = (sample)-2.76076847742355e-16;
+  p = p * x2 + (sample)2.00018790482477e-13;
+  p = p * x2 + (sample)-8.60467152213735e-11;
+  p = p * x2 + (sample)5.12229709037114e-08;
+  p = p * x2 + (sample)1.48572235717979e-05;
+  p = p * x2 + (sample)6.37261928875436e-04;
+  p = p * x2 + (sample)4.89352455891786e-03;
+  sample q = (sample)1.19825839466702e-06;
+  q = q * x2 + (sample)1.18534705686654e-04;
+  q = q * x2 + (sample)2.26843463243900e-03;
+  q = q * x2 + (sample)4.89352518554385e-03;
+  return x * p / q;
+}
+
+// Sine fold: sin(pi/2 x), which follows 'x' near 0,
+// reaches +/-1 at +/-1 and folds back beyond that.
+// Maximum absolute error 1.7e-7 for |x| <= 1;
+// larger 'x' lose accuracy as x + 1 is rounded (4.8e-5 at |x| = 1000).
+static inline sample sinefold(sample x) {
+  // triangle fold to -1 <= y <= 1 (period 4)
+  sample u = x + 1;
+  u -= 4 * floor(u * (sample)0.25);
+  sample y = u < 2 ? u - 1 : 3 - u;
+  // odd Taylor polynomial of sin(pi/2 y)
+  sample y2 = y * y;
+  sample p = (sample)-3.5988432352120853e-06;
+  p = p * y2 + (sample)1.6044118478735982e-04;
+  p = p * y2 + (sample)-4.6817541353186881e-03;
+  p = p * y2 + (sample)7.9692626246167046e-02;
+  p = p * y2 + (sample)-6.4596409750624625e-01;
+  p = p * y2 + (sample)1.5707963267948966;
+  return y * p;
+}
+
+// Cubic soft clip: 1.5 x - 0.5 x^3, reaching +/-1 with zero slope at +/-1,
+// constant beyond.  Slope 1.5 near 0.
+static inline sample cubicclip(sample x) {
+  sample y = x < -1 ? -1 : x > 1 ? 1 : x;
+  return (sample)1.5 * y - (sample)0.5 * y * y * y;
+}
+
+// Asymmetric soft clip: tanh(x + bias) - tanh(bias),
+// adding even harmonics; 0 maps to 0, and the output range
+// is -1 - tanh(bias) to 1 - tanh(bias).
+static inline sample asymclip(sample x, sample bias) {
+  return fasttanh(x + bias) - fasttanh(bias);
+}
+
 //---------------------------------------------------------------------
 // oscillators
 //---------------------------------------------------------------------
@@ -125,11 +317,23 @@ typedef struct { double phase; } PHASOR;
 
 static inline double phasor(PHASOR *p, double hz) {
   // can't use wrap as it is defined for sample which might be lower precision
-  p->phase += hz / SR; // increment according to frequency
+  p->phase += hz * rate().isr; // increment according to frequency
   p->phase -= floor(p->phase); // wrap to 0 to 1 range
   return p->phase;
 }
 
+// Phasor with a 32bit integer phase accumulator instead:
+// one cycle is 2^32, so the phase wraps exactly by integer overflow,
+// with the same resolution at all frequencies and no floor().
+// Valid for frequencies 'hz' between -SR/2 and +SR/2.
+// (dsp_simd.h has banks of 4 and 8 of these with waveforms)
+typedef struct { uint32_t phase; } PHASOR32;
+
+static inline sample phasor32(PHASOR32 *p, sample hz) {
+  p->phase += (uint32_t) (int32_t) (hz * rate().pincf); // increment according to frequency
+  return (p->phase >> 8) * (sample)5.9604644775390625e-8; // 0 to 1 range (2^-24 resolution)
+}
+
 //---------------------------------------------------------------------
 // filters
 //---------------------------------------------------------------------
@@ -146,7 +350,7 @@ typedef struct {
 } SAMPHOLD;
 
 // sample and hold function
-sample samphold(SAMPHOLD *s, sample value, sample trigger) {
+static inline sample samphold(SAMPHOLD *s, sample value, sample trigger) {
   if (trigger < s->trigger) {
         s->value = value;
   }
@@ -164,92 +368,208 @@ sample samphold(SAMPHOLD *s, sample value, sample trigger) {
 // the filters do not have a resonant peak in the frequency response
 #define flatq 0.7071067811865476
 
-// Generic biquad filter state.
-// Filter coefficients and input/output history
-// are stored in the same structure;
-// separating coefficients from signal history
-// would allow more sharing.
-// Coefficients and feedback history
-// are stored in double precision rather than sample
-// because the extra precision is necessary for accurate response.
-typedef struct { double b0, b1, b2, a1, a2, y1, y2; sample x1, x2; } BIQUAD;
+// Biquad filter coefficients, normalized so that a0 = 1.
+// One set of coefficients can be shared by any number of filter states
+// (for example one per channel).
+// The designs below compute in double precision;
+// BIQUAD_COEFFS holds them rounded to 'sample' for the fast path,
+// BIQUAD_COEFFS_DOUBLE keeps double precision, for filters whose
+// poles are very close to the unit circle (low frequency, high q).
+typedef struct { sample b0, b1, b2, a1, a2; } BIQUAD_COEFFS;
+typedef struct { double b0, b1, b2, a1, a2; } BIQUAD_COEFFS_DOUBLE;
+
+// Biquad filter state, for transposed direct form II
+// (two values of history instead of four).
+typedef struct { sample s1, s2; } BIQUAD_STATE;
+typedef struct { double s1, s2; } BIQUAD_STATE_DOUBLE;
+
+// Biquad filter function, transposed direct form II.
+static inline sample biquad(const BIQUAD_COEFFS *c, BIQUAD_STATE *s, sample x) {
+  sample y = c->b0 * x + s->s1;
+  s->s1 = c->b1 * x - c->a1 * y + s->s2;
+  s->s2 = c->b2 * x - c->a2 * y;
+  return y;
+}
 
-// Generic biquad filter function.
-static inline sample biquad(BIQUAD *bq, sample x0) {
-  double b0 = bq->b0, b1 = bq->b1, b2 = bq->b2, a1 = bq->a1, a2 = bq->a2;
-  double x1 = bq->x1, x2 = bq->x2, y1 = bq->y1, y2 = bq->y2;
-  double y0 = b0 * x0 + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
-  bq->y2 = y1;
-  bq->y1 = y0;
-  bq->x2 = x1;
-  bq->x1 = x0;
-  return y0;
+// Biquad filter function, transposed direct form II, double precision.
+static inline sample biquad(const BIQUAD_COEFFS_DOUBLE *c, BIQUAD_STATE_DOUBLE *s, sample x0) {
+  double x = x0;
+  double y = c->b0 * x + s->s1;
+  s->s1 = c->b1 * x - c->a1 * y + s->s2;
+  s->s2 = c->b2 * x - c->a2 * y;
+  return y;
 }
 
+// Cascade of 'sections' biquads (second order sections)
+// with coefficients c[k] and state s[k] for section k,
+// over a block of 'n' samples from 'x' to 'y' (which may be the same array).
+// Runs the whole block through each section in turn,
+// keeping each section's coefficients and state in registers.
+static inline void biquad_cascade(const BIQUAD_COEFFS *c, BIQUAD_STATE *s, int sections, sample *y, const sample *x, int n) {
+  for (int k = 0; k < sections; ++k) {
+    const sample b0 = c[k].b0, b1 = c[k].b1, b2 = c[k].b2, a1 = c[k].a1, a2 = c[k].a2;
+    sample s1 = s[k].s1, s2 = s[k].s2;
+    const sample *in = k == 0 ? x : y;
+    for (int i = 0; i < n; ++i) {
+      sample u = in[i];
+      sample v = b0 * u + s1;
+      s1 = b1 * u - a1 * v + s2;
+      s2 = b2 * u - a2 * v;
+      y[i] = v;
+    }
+    s[k].s1 = s1;
+    s[k].s2 = s2;
+  }
+}
+
+static inline void biquad_cascade(const BIQUAD_COEFFS_DOUBLE *c, BIQUAD_STATE_DOUBLE *s, int sections, sample *y, const sample *x, int n) {
+  for (int k = 0; k < sections; ++k) {
+    const double b0 = c[k].b0, b1 = c[k].b1, b2 = c[k].b2, a1 = c[k].a1, a2 = c[k].a2;
+    double s1 = s[k].s1, s2 = s[k].s2;
+    const sample *in = k == 0 ? x : y;
+    for (int i = 0; i < n; ++i) {
+      double u = in[i];
+      double v = b0 * u + s1;
+      s1 = b1 * u - a1 * v + s2;
+      s2 = b2 * u - a2 * v;
+      y[i] = v;
+    }
+    s[k].s1 = s1;
+    s[k].s2 = s2;
+  }
+}
+
+// Normalize and store coefficients (divide by 'a0').
+static inline BIQUAD_COEFFS_DOUBLE *biquad_normalize(BIQUAD_COEFFS_DOUBLE *c,
+  double b0, double b1, double b2, double a0, double a1, double a2) {
+  c->b0 = b0 / a0;
+  c->b1 = b1 / a0;
+  c->b2 = b2 / a0;
+  c->a1 = a1 / a0;
+  c->a2 = a2 / a0;
+  return c;
+}
+
+// Round double precision coefficients for the 'sample' precision path.
+static inline BIQUAD_COEFFS *biquad_round(BIQUAD_COEFFS *c, const BIQUAD_COEFFS_DOUBLE *d) {
+  c->b0 = d->b0;
+  c->b1 = d->b1;
+  c->b2 = d->b2;
+  c->a1 = d->a1;
+  c->a2 = d->a2;
+  return c;
+}
+
+// The designs below are for filters running at sample rate 'r',
+// by default the audio rate; pass another rate_constant()
+// for filters running at a lower (control) rate.
+
 // Calculate the coefficients for a lowpass biquad filter
 // with cutoff frequency 'hz' (in Hz), and q-factor 'q'.
-static inline BIQUAD *lowpass(BIQUAD *bq, sample hz, sample q) {
-  double w0 = hz * 2*M_PI / SR;
+static inline BIQUAD_COEFFS_DOUBLE *lowpass(BIQUAD_COEFFS_DOUBLE *c, sample hz, sample q, const RATE &r = rate()) {
+  double w0 = hz * r.w;
   double a = fabs(sin(w0) / (2 * q));
-  double c = cos(w0);
-  double b0 = (1 - c) / 2, b1 = 1 - c, b2 = (1 - c) / 2;
-  double a0 = 1 + a, a1 = -2 * c, a2 = 1 - a;
-  bq->b0 = b0 / a0;
-  bq->b1 = b1 / a0;
-  bq->b2 = b2 / a0;
-  bq->a1 = a1 / a0;
-  bq->a2 = a2 / a0;
-  return bq;
+  double co = cos(w0);
+  return biquad_normalize(c, (1 - co) / 2, 1 - co, (1 - co) / 2, 1 + a, -2 * co, 1 - a);
 }
 
 // Calculate the coefficients for a highpass biquad filter
 // with cutoff frequency 'hz' (in Hz), and q-factor 'q'.
-static inline BIQUAD *highpass(BIQUAD *bq, sample hz, sample q) {
-  double w0 = hz * 2*M_PI / SR;
+static inline BIQUAD_COEFFS_DOUBLE *highpass(BIQUAD_COEFFS_DOUBLE *c, sample hz, sample q, const RATE &r = rate()) {
+  double w0 = hz * r.w;
   double a = fabs(sin(w0) / (2 * q));
-  double c = cos(w0);
-  double b0 = (1 + c) / 2, b1 = -(1 + c), b2 = (1 + c) / 2;
-  double a0 = 1 + a, a1 = -2 * c, a2 = 1 - a;
-  bq->b0 = b0 / a0;
-  bq->b1 = b1 / a0;
-  bq->b2 = b2 / a0;
-  bq->a1 = a1 / a0;
-  bq->a2 = a2 / a0;
-  return bq;
+  double co = cos(w0);
+  return biquad_normalize(c, (1 + co) / 2, -(1 + co), (1 + co) / 2, 1 + a, -2 * co, 1 - a);
 }
 
 // Calculate the coefficients for a bandpass biquad filter
 // with center frequency 'hz' (in Hz), and q-factor 'q'.
-static inline BIQUAD *bandpass(BIQUAD *bq, sample hz, sample q) {
-  double w0 = hz * 2*M_PI / SR;
+static inline BIQUAD_COEFFS_DOUBLE *bandpass(BIQUAD_COEFFS_DOUBLE *c, sample hz, sample q, const RATE &r = rate()) {
+  double w0 = hz * r.w;
   double a = fabs(sin(w0) / (2 * q));
-  double c = cos(w0);
-  double b0 = a, b1 = 0, b2 = -a;
-  double a0 = 1 + a, a1 = -2 * c, a2 = 1 - a;
-  bq->b0 = b0 / a0;
-  bq->b1 = b1 / a0;
-  bq->b2 = b2 / a0;
-  bq->a1 = a1 / a0;
-  bq->a2 = a2 / a0;
-  return bq;
+  double co = cos(w0);
+  return biquad_normalize(c, a, 0, -a, 1 + a, -2 * co, 1 - a);
 }
 
 // Calculate the coefficients for a notch biquad filter
 // with center frequency 'hz' (in Hz), and q-factor 'q'.
-static inline BIQUAD *notch(BIQUAD *bq, sample hz, sample q) {
-  double w0 = hz * 2*M_PI / SR;
+static inline BIQUAD_COEFFS_DOUBLE *notch(BIQUAD_COEFFS_DOUBLE *c, sample hz, sample q, const RATE &r = rate()) {
+  double w0 = hz * r.w;
   double a = fabs(sin(w0) / (2 * q));
-  double c = cos(w0);
-  double b0 = 1, b1 = -2 * c, b2 = 1;
-  double a0 = 1 + a, a1 = -2 * c, a2 = 1 - a;
-  bq->b0 = b0 / a0;
-  bq->b1 = b1 / a0;
-  bq->b2 = b2 / a0;
-  bq->a1 = a1 / a0;
-  bq->a2 = a2 / a0;
+  double co = cos(w0);
+  return biquad_normalize(c, 1, -2 * co, 1, 1 + a, -2 * co, 1 - a);
+}
+
+// The same designs for the 'sample' precision path.
+static inline BIQUAD_COEFFS *lowpass(BIQUAD_COEFFS *c, sample hz, sample q, const RATE &r = rate()) {
+  BIQUAD_COEFFS_DOUBLE d;
+  return biquad_round(c, lowpass(&d, hz, q, r));
+}
+
+static inline BIQUAD_COEFFS *highpass(BIQUAD_COEFFS *c, sample hz, sample q, const RATE &r = rate()) {
+  BIQUAD_COEFFS_DOUBLE d;
+  return biquad_round(c, highpass(&d, hz, q, r));
+}
+
+static inline BIQUAD_COEFFS *bandpass(BIQUAD_COEFFS *c, sample hz, sample q, const RATE &r = rate()) {
+  BIQUAD_COEFFS_DOUBLE d;
+  return biquad_round(c, bandpass(&d, hz, q, r));
+}
+
+static inline BIQUAD_COEFFS *notch(BIQUAD_COEFFS *c, sample hz, sample q, const RATE &r = rate()) {
+  BIQUAD_COEFFS_DOUBLE d;
+  return biquad_round(c, notch(&d, hz, q, r));
+}
+
+//---------------------------------------------------------------------
+// biquad with coefficients and history in one structure
+// (direct form I, double precision), kept for existing code;
+// prefer the split coefficients / state above for new code.
+
+typedef struct { double b0, b1, b2, a1, a2, y1, y2; sample x1, x2; } BIQUAD;
+
+// Generic biquad filter function.
+static inline sample biquad(BIQUAD *bq, sample x0) {
+  double b0 = bq->b0, b1 = bq->b1, b2 = bq->b2, a1 = bq->a1, a2 = bq->a2;
+  double x1 = bq->x1, x2 = bq->x2, y1 = bq->y1, y2 = bq->y2;
+  double y0 = b0 * x0 + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+  bq->y2 = y1;
+  bq->y1 = y0;
+  bq->x2 = x1;
+  bq->x1 = x0;
+  return y0;
+}
+
+// Copy designed coefficients into the combined structure.
+static inline BIQUAD *biquad_set(BIQUAD *bq, const BIQUAD_COEFFS_DOUBLE *c) {
+  bq->b0 = c->b0;
+  bq->b1 = c->b1;
+  bq->b2 = c->b2;
+  bq->a1 = c->a1;
+  bq->a2 = c->a2;
   return bq;
 }
 
+static inline BIQUAD *lowpass(BIQUAD *bq, sample hz, sample q, const RATE &r = rate()) {
+  BIQUAD_COEFFS_DOUBLE c;
+  return biquad_set(bq, lowpass(&c, hz, q, r));
+}
+
+static inline BIQUAD *highpass(BIQUAD *bq, sample hz, sample q, const RATE &r = rate()) {
+  BIQUAD_COEFFS_DOUBLE c;
+  return biquad_set(bq, highpass(&c, hz, q, r));
+}
+
+static inline BIQUAD *bandpass(BIQUAD *bq, sample hz, sample q, const RATE &r = rate()) {
+  BIQUAD_COEFFS_DOUBLE c;
+  return biquad_set(bq, bandpass(&c, hz, q, r));
+}
+
+static inline BIQUAD *notch(BIQUAD *bq, sample hz, sample q, const RATE &r = rate()) {
+  BIQUAD_COEFFS_DOUBLE c;
+  return biquad_set(bq, notch(&c, hz, q, r));
+}
+
 //---------------------------------------------------------------------
 // simple filters
 // based on pd's [vcf~] [lop~] [hip~]
@@ -267,7 +587,7 @@ typedef struct { double re, im; } VCF;
 static inline sample vcf(VCF *s, sample x, sample hz, sample q) {
   double qinv = q > 0 ? 1 / q : 0;
   double ampcorrect = 2 - 2 / (q + 2);
-  double cf = hz * 2*M_PI / SR;
+  double cf = hz * rate().w;
   if (cf < 0) { cf = 0; }
   double r = qinv > 0 ? 1 - cf * qinv : 0;
   if (r < 0) { r = 0; }
@@ -289,7 +609,7 @@ typedef struct { float re, im; } VCFF;
 static inline sample vcff(VCFF *s, sample x, sample hz, sample q) {
   float qinv = q > 0 ? 1 / q : 0;
   float ampcorrect = 2 - 2 / (q + 2);
-  float cf = hz * 2*M_PI / SR;
+  float cf = hz * rate().wf;
   if (cf < 0) { cf = 0; }
   float r = qinv > 0 ? 1 - cf * qinv : 0;
   if (r < 0) { r = 0; }
@@ -311,7 +631,7 @@ typedef struct { double y; } LOP;
 // low pass filter function
 // (double precision version for more accuracy, less speed)
 static inline sample lop(LOP *s, sample x, sample hz) {
-  double c = clamp(2*M_PI * hz / SR, 0, 1);
+  double c = clamp(rate().w * hz, 0, 1);
   return s->y = mix(x, s->y, 1 - c);
 }
 
@@ -322,7 +642,7 @@ typedef struct { float y; } LOPF;
 // low pass filter function
 // (single precision version for more speed, less accuracy)
 static inline sample lopf(LOPF *s, sample x, sample hz) {
-  float c = clamp((float(2*M_PI) / SR) * hz, 0, 1);
+  float c = clamp(rate().wf * hz, 0, 1);
   return s->y = mix(s->y, x, c);
 }
 
@@ -333,7 +653,7 @@ typedef struct { double y; } HIP;
 // high pass filter state
 // (double precision version for more accuracy, less speed)
 static inline sample hip(HIP *s, sample x, sample hz) {
-  double c = clamp(1 - 2*M_PI * hz / SR, 0, 1);
+  double c = clamp(1 - rate().w * hz, 0, 1);
   double n = (1 + c) / 2;
   double y = x + c * s->y;
   double o = n * (y - s->y);
@@ -354,8 +674,9 @@ static inline sample hip(HIP *s, sample x, sample hz) {
 // The maximum delay time in samples is determined by 'length'.
 typedef struct { int length, woffset; } DELAY;
 
-// For example, a delay line with a maximum delay time of 1 second:
-typedef struct { DELAY delay; float buffer[SR]; } DELAY1s;
+// For example, a delay line with a maximum delay time of 1 second
+// (at sample rates up to SR_MAX):
+typedef struct { DELAY delay; float buffer[SR_MAX]; } DELAY1s;
 
 // Write a value to the delay line, incrementing the write index.
 static inline void delwrite(DELAY *del, sample x0) {
@@ -380,7 +701,7 @@ static inline sample delread1(DELAY *del, sample ms) {
   int l = del->length;
   l = (l > 0) ? l : 1;
   int w = del->woffset;
-  int d = ms / (sample)1000 * SR; // convert milliseconds to samples
+  int d = ms * rate().spmsf; // convert milliseconds to samples
   d = (0 < d && d < l) ? d : 0; // check in range
   int r = w - d; // make relative to write index
   r = r < 0 ? r + l : r; // wrap around the ring buffer
@@ -396,7 +717,7 @@ static inline sample delread2(DELAY *del, sample ms) {
   int l = del->length;
   l = (l > 0) ? l : 1;
   int w = del->woffset;
-  sample d = ms / (sample)1000 * SR; // convert milliseconds to samples
+  sample d = ms * rate().spmsf; // convert milliseconds to samples
   int d0 = floor(d); // find neighbouring indices
   int d1 = d0 + 1;
   sample t = d - d0; // find fractional distance through range
@@ -421,7 +742,7 @@ static inline sample delread4(DELAY *del, sample ms) {
   int l = del->length;
   l = (l > 0) ? l : 1;
   int w = del->woffset;
-  sample d = ms / (sample) 1000 * SR; // convert milliseconds to samples
+  sample d = ms * rate().spmsf; // convert milliseconds to samples
   int d1 = floor(d); // find neighbouring indices
   int d0 = d1 - 1;
   int d2 = d1 + 1;
@@ -451,3 +772,117 @@ static inline sample delread4(DELAY *del, sample ms) {
 }
 
 //---------------------------------------------------------------------
+// masked delay
+
+// Delay line with a power-of-two length,
+// wrapping the ring buffer with a bit mask
+// instead of comparing and branching on every read and write.
+
+// Masked delay state structure.
+// Must be followed in memory by an array of float
+// 'mask + 1' items in length, where 'mask + 1' is a power of two.
+// Delay times from 1 to 'mask' samples (minus 2 for cubic interpolation)
+// are valid; other times wrap around the ring buffer,
+// reading old data but never outside the array.
+typedef struct { int mask, woffset; } MDELAY;
+
+// For example, a delay line with a maximum delay time of 1 second
+// (at sample rates up to 65536 Hz):
+typedef struct { MDELAY delay; float buffer[65536]; } MDELAY1s;
+
+// Write a value to the delay line, incrementing the write index.
+static inline void mdelwrite(MDELAY *del, sample x0) {
+  float *buffer = (float *) (del + 1);
+  int w = del->woffset;
+  buffer[w] = x0;
+  del->woffset = (w + 1) & del->mask;
+}
+
+// Write a block of 'n' values (at most 'mask + 1') to the delay line,
+// incrementing the write index.
+static inline void mdelwrite_block(MDELAY *del, const float *x, int n) {
+  float *buffer = (float *) (del + 1);
+  int w = del->woffset;
+  int m = del->mask + 1 - w; // space before the wrap point
+  if (n <= m) {
+    memcpy(buffer + w, x, n * sizeof(*x));
+  } else {
+    memcpy(buffer + w, x, m * sizeof(*x));
+    memcpy(buffer, x + m, (n - m) * sizeof(*x));
+  }
+  del->woffset = (w + n) & del->mask;
+}
+
+// Read a value from the delay line without interpolation,
+// at 'ms' milliseconds behind the write index.
+// See delread1() for the effects of the lack of interpolation.
+static inline sample mdelread1(const MDELAY *del, sample ms) {
+  const float *buffer = (const float *) (del + 1);
+  int d = ms * rate().spmsf; // convert milliseconds to samples
+  return buffer[(del->woffset - d) & del->mask];
+}
+
+// Read a value from the delay line with linear interpolation,
+// at 'ms' milliseconds behind the write index.
+static inline sample mdelread2(const MDELAY *del, sample ms) {
+  const float *buffer = (const float *) (del + 1);
+  int m = del->mask;
+  sample d = ms * rate().spmsf; // convert milliseconds to samples
+  int d0 = d; // rounds down, as valid delay times are positive
+  sample t = d - d0; // find fractional distance through range
+  int r0 = del->woffset - d0; // make relative to write index
+  sample y0 = buffer[r0 & m]; // read from the buffer
+  sample y1 = buffer[(r0 - 1) & m];
+  return y0 + t * (y1 - y0); // linear interpolation
+}
+
+// Read a value from the delay line with cubic interpolation,
+// at 'ms' milliseconds behind the write index.
+// Uses the same interpolation as delread4().
+static inline sample mdelread4(const MDELAY *del, sample ms) {
+  const float *buffer = (const float *) (del + 1);
+  int m = del->mask;
+  sample d = ms * rate().spmsf; // convert milliseconds to samples
+  int d1 = d; // rounds down, as valid delay times are positive
+  sample t = d - d1; // find fractional distance through range
+  int r1 = del->woffset - d1; // make relative to write index
+  sample y0 = buffer[(r1 + 1) & m]; // read from the buffer
+  sample y1 = buffer[r1 & m];
+  sample y2 = buffer[(r1 - 1) & m];
+  sample y3 = buffer[(r1 - 2) & m];
+  sample a0 = -t*t*t + 2*t*t - t; // cubic interpolation
+  sample a1 = 3*t*t*t - 5*t*t + 2;
+  sample a2 = -3*t*t*t + 4*t*t + t;
+  sample a3 = t*t*t - t*t;
+  return (a0 * y0 + a1 * y1 + a2 * y2 + a3 * y3) / 2;
+}
+
+// Read a block of 'n' values from the delay line with linear interpolation,
+// at a fixed 'ms' milliseconds behind the write index (for the first value)
+// and the following indices (for the rest),
+// for processing a block before writing it with mdelwrite_block();
+// the delay time should be at least 'n' samples.
+// When the block does not cross the wrap point of the ring buffer
+// it is read without masking, which compilers can vectorize.
+static inline void mdelread2_block(const MDELAY *del, float *y, sample ms, int n) {
+  const float *buffer = (const float *) (del + 1);
+  int m = del->mask;
+  sample d = ms * rate().spmsf; // convert milliseconds to samples
+  int d0 = d; // rounds down, as valid delay times are positive
+  sample t = d - d0; // find fractional distance through range
+  int r1 = (del->woffset - d0 - 1) & m; // first index of y1
+  if (r1 + n + 1 <= m + 1) {
+    const float *x1 = buffer + r1;
+    for (int i = 0; i < n; ++i) {
+      y[i] = x1[i + 1] + t * (x1[i] - x1[i + 1]);
+    }
+  } else {
+    for (int i = 0; i < n; ++i) {
+      sample y0 = buffer[(r1 + i + 1) & m];
+      sample y1 = buffer[(r1 + i) & m];
+      y[i] = y0 + t * (y1 - y0);
+    }
+  }
+}
+
+//---------------------------------------------------------------------
@@ -0,0 +1,1688 @@
+#pragma once
+
+//---------------------------------------------------------------------
+// portable SIMD vectors for dsp stuff
+// 2026-10-16, kernels moved from dsp_neon.h
+//
+// 'sample4' (4 floats) and 'sample8' (8 floats) vector types
+// with NEON, SSE/AVX and scalar backends selected at compile time,
+// so the same kernel source is vectorised on Bela and on hosts.
+//
+// arithmetic uses the usual operators (+ - * /) between vectors
+// and elements are accessed with [i], as with GCC/Clang vectors;
+// scalars must be broadcast explicitly with splat4() / splat8()
+// (mixed vector-scalar operators are not portable between compilers).
+//
+// backends:
+// NEON on ARM, SSE2 on x86 (AVX for sample8 when enabled),
+// scalar otherwise (plain loops, auto-vectorised if possible).
+// #define SIMD_SCALAR 1 before including to force the scalar backend,
+// which is useful for checking the vector backends.
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include "dsp.h"
+
+// sample8 is passed by value without AVX, which GCC warns about
+#if defined(__GNUC__) && ! defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+//---------------------------------------------------------------------
+// backend selection
+//---------------------------------------------------------------------
+
+#if defined(SIMD_SCALAR) && SIMD_SCALAR
+#define SIMD_NEON 0
+#define SIMD_SSE 0
+#define SIMD_AVX 0
+#else
+#undef SIMD_SCALAR
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define SIMD_NEON 1
+#define SIMD_SSE 0
+#define SIMD_AVX 0
+#define SIMD_SCALAR 0
+#elif defined(__SSE2__)
+#define SIMD_NEON 0
+#define SIMD_SSE 1
+#ifdef __AVX__
+#define SIMD_AVX 1
+#else
+#define SIMD_AVX 0
+#endif
+#define SIMD_SCALAR 0
+#else
+#define SIMD_NEON 0
+#define SIMD_SSE 0
+#define SIMD_AVX 0
+#define SIMD_SCALAR 1
+#endif
+#endif
+
+//---------------------------------------------------------------------
+// common definitions
+//---------------------------------------------------------------------
+
+#if SIMD_NEON
+#include <arm_neon.h>
+#endif
+#if SIMD_SSE
+#include <immintrin.h>
+#endif
+
+// a vector of 4 individual audio samples (4 single numbers)
+// and a vector of 4 32bit integers (for bit manipulation)
+#if SIMD_NEON
+typedef float32x4_t sample4;
+typedef int32x4_t isample4;
+#elif SIMD_SSE
+typedef __m128 sample4;
+typedef int32_t isample4 __attribute__((vector_size(16)));
+#else
+typedef float sample4 __attribute__((vector_size(16)));
+typedef int32_t isample4 __attribute__((vector_size(16)));
+#endif
+
+// a vector of 8 individual audio samples (8 single numbers)
+// and a vector of 8 32bit integers (for bit manipulation)
+// without AVX, operations are done on two halves
+#if SIMD_AVX
+typedef __m256 sample8;
+#else
+typedef float sample8 __attribute__((vector_size(32)));
+#endif
+typedef int32_t isample8 __attribute__((vector_size(32)));
+
+//---------------------------------------------------------------------
+// 4-wide primitives
+//---------------------------------------------------------------------
+
+// Broadcast 'x' to all elements.
+static inline sample4 splat4(float x)
+{
+#if SIMD_NEON
+	return vdupq_n_f32(x);
+#elif SIMD_SSE
+	return _mm_set1_ps(x);
+#else
+	sample4 r = { x, x, x, x };
+	return r;
+#endif
+}
+
+// Load 4 samples from memory (need not be aligned).
+static inline sample4 load4(const float *p)
+{
+#if SIMD_NEON
+	return vld1q_f32(p);
+#elif SIMD_SSE
+	return _mm_loadu_ps(p);
+#else
+	sample4 r;
+	memcpy(&r, p, sizeof(r));
+	return r;
+#endif
+}
+
+// Store 4 samples to memory (need not be aligned).
+static inline void store4(float *p, const sample4 &x)
+{
+#if SIMD_NEON
+	vst1q_f32(p, x);
+#elif SIMD_SSE
+	_mm_storeu_ps(p, x);
+#else
+	memcpy(p, &x, sizeof(x));
+#endif
+}
+
+// Element-wise minimum.
+static inline sample4 min4(const sample4 &a, const sample4 &b)
+{
+#if SIMD_NEON
+	return vminq_f32(a, b);
+#elif SIMD_SSE
+	return _mm_min_ps(a, b);
+#else
+	sample4 r;
+	for (int i = 0; i < 4; ++i) { r[i] = a[i] < b[i] ? a[i] : b[i]; }
+	return r;
+#endif
+}
+
+// Element-wise maximum.
+static inline sample4 max4(const sample4 &a, const sample4 &b)
+{
+#if SIMD_NEON
+	return vmaxq_f32(a, b);
+#elif SIMD_SSE
+	return _mm_max_ps(a, b);
+#else
+	sample4 r;
+	for (int i = 0; i < 4; ++i) { r[i] = a[i] > b[i] ? a[i] : b[i]; }
+	return r;
+#endif
+}
+
+// Element-wise absolute value.
+static inline sample4 abs4(const sample4 &x)
+{
+#if SIMD_NEON
+	return vabsq_f32(x);
+#elif SIMD_SSE
+	return _mm_andnot_ps(_mm_set1_ps(-0.0f), x);
+#else
+	sample4 r;
+	for (int i = 0; i < 4; ++i) { r[i] = fabsf(x[i]); }
+	return r;
+#endif
+}
+
+// Element-wise reciprocal 1 / x.
+// NEON has no vector division: the estimate is refined by two Newton steps
+// (error about 1 ulp, and 0 or infinity give NaN).
+static inline sample4 recip4(const sample4 &x)
+{
+#if SIMD_NEON
+	float32x4_t r = vrecpeq_f32(x);
+	r = vmulq_f32(vrecpsq_f32(x, r), r);
+	r = vmulq_f32(vrecpsq_f32(x, r), r);
+	return r;
+#elif SIMD_SSE
+	return _mm_div_ps(_mm_set1_ps(1.0f), x);
+#else
+	return splat4(1.0f) / x;
+#endif
+}
+
+// Element-wise reciprocal square root 1 / sqrt(x).
+// NEON refines its estimate by two Newton steps (error a few ulp).
+static inline sample4 rsqrt4(const sample4 &x)
+{
+#if SIMD_NEON
+	float32x4_t r = vrsqrteq_f32(x);
+	r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(x, r), r), r);
+	r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(x, r), r), r);
+	return r;
+#elif SIMD_SSE
+	return _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(x));
+#else
+	sample4 r;
+	for (int i = 0; i < 4; ++i) { r[i] = 1.0f / sqrtf(x[i]); }
+	return r;
+#endif
+}
+
+// Broadcast integer 'x' to all elements.
+static inline isample4 isplat4(int32_t x)
+{
+	isample4 r = { x, x, x, x };
+	return r;
+}
+
+// Shift integers left by 'K' bits.
+template <int K>
+static inline isample4 shl4(const isample4 &x)
+{
+#if SIMD_NEON
+	return vshlq_n_s32(x, K);
+#else
+	typedef uint32_t u4 __attribute__((vector_size(16)));
+	return (isample4) ((u4) x << K);
+#endif
+}
+
+// Shift integers right by 'K' bits, filling with zeros.
+template <int K>
+static inline isample4 shr4(const isample4 &x)
+{
+#if SIMD_NEON
+	return vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(x), K));
+#else
+	typedef uint32_t u4 __attribute__((vector_size(16)));
+	return (isample4) ((u4) x >> K);
+#endif
+}
+
+// Reinterpret the bits of floats as integers.
+static inline isample4 bits4(const sample4 &x)
+{
+	isample4 r;
+	memcpy(&r, &x, sizeof(r));
+	return r;
+}
+
+// Reinterpret the bits of integers as floats.
+static inline sample4 unbits4(const isample4 &x)
+{
+	sample4 r;
+	memcpy(&r, &x, sizeof(r));
+	return r;
+}
+
+// Convert floats to integers, rounding towards zero.
+static inline isample4 toint4(const sample4 &x)
+{
+#if SIMD_NEON
+	return vcvtq_s32_f32(x);
+#elif SIMD_SSE
+	return (isample4) _mm_cvttps_epi32(x);
+#else
+	isample4 r;
+	for (int i = 0; i < 4; ++i) { r[i] = (int32_t) x[i]; }
+	return r;
+#endif
+}
+
+// Convert integers to floats.
+static inline sample4 tofloat4(const isample4 &x)
+{
+#if SIMD_NEON
+	return vcvtq_f32_s32(x);
+#elif SIMD_SSE
+	return _mm_cvtepi32_ps((__m128i) x);
+#else
+	sample4 r;
+	for (int i = 0; i < 4; ++i) { r[i] = (float) x[i]; }
+	return r;
+#endif
+}
+
+// Element-wise 'a < b ? x : y'.
+static inline sample4 select4(const sample4 &a, const sample4 &b, const sample4 &x, const sample4 &y)
+{
+#if SIMD_NEON
+	return vbslq_f32(vcltq_f32(a, b), x, y);
+#elif SIMD_SSE
+	__m128 m = _mm_cmplt_ps(a, b);
+	return _mm_or_ps(_mm_and_ps(m, x), _mm_andnot_ps(m, y));
+#else
+	sample4 r;
+	for (int i = 0; i < 4; ++i) { r[i] = a[i] < b[i] ? x[i] : y[i]; }
+	return r;
+#endif
+}
+
+// Round down to an integer value (as float).
+// Valid for |x| < 2^31.
+static inline sample4 floor4(const sample4 &x)
+{
+#if SIMD_SSE && defined(__SSE4_1__)
+	return _mm_floor_ps(x);
+#elif SIMD_NEON && defined(__ARM_FEATURE_DIRECTED_ROUNDING)
+	return vrndmq_f32(x);
+#else
+	sample4 t = tofloat4(toint4(x));
+	return select4(x, t, t - splat4(1.0f), t);
+#endif
+}
+
+// Sum of all elements.
+static inline float sum4(const sample4 &x)
+{
+#if SIMD_NEON
+	float32x2_t t = vadd_f32(vget_low_f32(x), vget_high_f32(x));
+	return vget_lane_f32(vpadd_f32(t, t), 0);
+#elif SIMD_SSE
+	__m128 t = _mm_add_ps(x, _mm_movehl_ps(x, x));
+	return _mm_cvtss_f32(_mm_add_ss(t, _mm_shuffle_ps(t, t, 1)));
+#else
+	return (x[0] + x[2]) + (x[1] + x[3]);
+#endif
+}
+
+//---------------------------------------------------------------------
+// 8-wide primitives
+//---------------------------------------------------------------------
+
+#if ! SIMD_AVX
+
+// Split into and join from two 4-wide halves.
+static inline sample4 low4(const sample8 &x)
+{
+	sample4 r;
+	memcpy(&r, &x, sizeof(r));
+	return r;
+}
+
+static inline sample4 high4(const sample8 &x)
+{
+	sample4 r;
+	memcpy(&r, ((const char *) &x) + sizeof(r), sizeof(r));
+	return r;
+}
+
+static inline sample8 join8(const sample4 &lo, const sample4 &hi)
+{
+	sample8 r;
+	memcpy(&r, &lo, sizeof(lo));
+	memcpy(((char *) &r) + sizeof(lo), &hi, sizeof(hi));
+	return r;
+}
+
+#endif
+
+// Broadcast 'x' to all elements.
+static inline sample8 splat8(float x)
+{
+#if SIMD_AVX
+	return _mm256_set1_ps(x);
+#else
+	sample8 r = { x, x, x, x, x, x, x, x };
+	return r;
+#endif
+}
+
+// Load 8 samples from memory (need not be aligned).
+static inline sample8 load8(const float *p)
+{
+#if SIMD_AVX
+	return _mm256_loadu_ps(p);
+#else
+	return join8(load4(p), load4(p + 4));
+#endif
+}
+
+// Store 8 samples to memory (need not be aligned).
+static inline void store8(float *p, const sample8 &x)
+{
+#if SIMD_AVX
+	_mm256_storeu_ps(p, x);
+#else
+	store4(p, low4(x));
+	store4(p + 4, high4(x));
+#endif
+}
+
+// Element-wise minimum.
+static inline sample8 min8(const sample8 &a, const sample8 &b)
+{
+#if SIMD_AVX
+	return _mm256_min_ps(a, b);
+#else
+	return join8(min4(low4(a), low4(b)), min4(high4(a), high4(b)));
+#endif
+}
+
+// Element-wise maximum.
+static inline sample8 max8(const sample8 &a, const sample8 &b)
+{
+#if SIMD_AVX
+	return _mm256_max_ps(a, b);
+#else
+	return join8(max4(low4(a), low4(b)), max4(high4(a), high4(b)));
+#endif
+}
+
+// Element-wise absolute value.
+static inline sample8 abs8(const sample8 &x)
+{
+#if SIMD_AVX
+	return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), x);
+#else
+	return join8(abs4(low4(x)), abs4(high4(x)));
+#endif
+}
+
+// Element-wise reciprocal 1 / x.
+static inline sample8 recip8(const sample8 &x)
+{
+#if SIMD_AVX
+	return _mm256_div_ps(_mm256_set1_ps(1.0f), x);
+#else
+	return join8(recip4(low4(x)), recip4(high4(x)));
+#endif
+}
+
+// Element-wise reciprocal square root 1 / sqrt(x).
+static inline sample8 rsqrt8(const sample8 &x)
+{
+#if SIMD_AVX
+	return _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(x));
+#else
+	return join8(rsqrt4(low4(x)), rsqrt4(high4(x)));
+#endif
+}
+
+// Broadcast integer 'x' to all elements.
+static inline isample8 isplat8(int32_t x)
+{
+	isample8 r = { x, x, x, x, x, x, x, x };
+	return r;
+}
+
+// Shift integers left by 'K' bits.
+template <int K>
+static inline isample8 shl8(const isample8 &x)
+{
+	typedef uint32_t u8 __attribute__((vector_size(32)));
+	return (isample8) ((u8) x << K);
+}
+
+// Shift integers right by 'K' bits, filling with zeros.
+template <int K>
+static inline isample8 shr8(const isample8 &x)
+{
+	typedef uint32_t u8 __attribute__((vector_size(32)));
+	return (isample8) ((u8) x >> K);
+}
+
+// Reinterpret the bits of floats as integers.
+static inline isample8 bits8(const sample8 &x)
+{
+	isample8 r;
+	memcpy(&r, &x, sizeof(r));
+	return r;
+}
+
+// Reinterpret the bits of integers as floats.
+static inline sample8 unbits8(const isample8 &x)
+{
+	sample8 r;
+	memcpy(&r, &x, sizeof(r));
+	return r;
+}
+
+// Convert floats to integers, rounding towards zero.
+static inline isample8 toint8(const sample8 &x)
+{
+#if SIMD_AVX
+	return (isample8) _mm256_cvttps_epi32(x);
+#else
+	isample8 r;
+	isample4 lo = toint4(low4(x)), hi = toint4(high4(x));
+	memcpy(&r, &lo, sizeof(lo));
+	memcpy(((char *) &r) + sizeof(lo), &hi, sizeof(hi));
+	return r;
+#endif
+}
+
+// Convert integers to floats.
+static inline sample8 tofloat8(const isample8 &x)
+{
+#if SIMD_AVX
+	return _mm256_cvtepi32_ps((__m256i) x);
+#else
+	isample4 lo, hi;
+	memcpy(&lo, &x, sizeof(lo));
+	memcpy(&hi, ((const char *) &x) + sizeof(lo), sizeof(hi));
+	return join8(tofloat4(lo), tofloat4(hi));
+#endif
+}
+
+// Element-wise 'a < b ? x : y'.
+static inline sample8 select8(const sample8 &a, const sample8 &b, const sample8 &x, const sample8 &y)
+{
+#if SIMD_AVX
+	return _mm256_blendv_ps(y, x, _mm256_cmp_ps(a, b, _CMP_LT_OQ));
+#else
+	return join8(select4(low4(a), low4(b), low4(x), low4(y)), select4(high4(a), high4(b), high4(x), high4(y)));
+#endif
+}
+
+// Round down to an integer value (as float).
+// Valid for |x| < 2^31.
+static inline sample8 floor8(const sample8 &x)
+{
+#if SIMD_AVX
+	return _mm256_floor_ps(x);
+#else
+	return join8(floor4(low4(x)), floor4(high4(x)));
+#endif
+}
+
+// Sum of all elements.
+static inline float sum8(const sample8 &x)
+{
+#if SIMD_AVX
+	return sum4(_mm_add_ps(_mm256_castps256_ps128(x), _mm256_extractf128_ps(x, 1)));
+#else
+	return sum4(low4(x) + high4(x));
+#endif
+}
+
+//---------------------------------------------------------------------
+// width-generic access to the primitives, for writing kernels once
+// as templates over the vector type V (sample4 or sample8);
+// scalar versions of the kernels run the 4-wide version on a broadcast value
+// (plain float code would need branches or library calls for floor and select)
+//---------------------------------------------------------------------
+
+template <typename V> static inline V vsplat(float x);
+template <> inline sample4 vsplat<sample4>(float x) { return splat4(x); }
+template <> inline sample8 vsplat<sample8>(float x) { return splat8(x); }
+
+template <typename V> static inline V vload(const float *p);
+template <> inline sample4 vload<sample4>(const float *p) { return load4(p); }
+template <> inline sample8 vload<sample8>(const float *p) { return load8(p); }
+
+static inline void vstore(float *p, const sample4 &x) { store4(p, x); }
+static inline void vstore(float *p, const sample8 &x) { store8(p, x); }
+static inline sample4 vmin(const sample4 &a, const sample4 &b) { return min4(a, b); }
+static inline sample8 vmin(const sample8 &a, const sample8 &b) { return min8(a, b); }
+static inline sample4 vmax(const sample4 &a, const sample4 &b) { return max4(a, b); }
+static inline sample8 vmax(const sample8 &a, const sample8 &b) { return max8(a, b); }
+static inline sample4 vabs(const sample4 &x) { return abs4(x); }
+static inline sample8 vabs(const sample8 &x) { return abs8(x); }
+static inline sample4 vrecip(const sample4 &x) { return recip4(x); }
+static inline sample8 vrecip(const sample8 &x) { return recip8(x); }
+static inline sample4 vrsqrt(const sample4 &x) { return rsqrt4(x); }
+static inline sample8 vrsqrt(const sample8 &x) { return rsqrt8(x); }
+static inline sample4 vfloor(const sample4 &x) { return floor4(x); }
+static inline sample8 vfloor(const sample8 &x) { return floor8(x); }
+static inline sample4 vselect(const sample4 &a, const sample4 &b, const sample4 &x, const sample4 &y) { return select4(a, b, x, y); }
+static inline sample8 vselect(const sample8 &a, const sample8 &b, const sample8 &x, const sample8 &y) { return select8(a, b, x, y); }
+static inline float vsum(const sample4 &x) { return sum4(x); }
+static inline float vsum(const sample8 &x) { return sum8(x); }
+
+// integer vectors I (isample4 or isample8) are for bit manipulation:
+// use only & | ^ + - between two of them, which all compilers support,
+// and vshl / vshr for shifts
+template <typename I> static inline I visplat(int32_t x);
+template <> inline isample4 visplat<isample4>(int32_t x) { return isplat4(x); }
+template <> inline isample8 visplat<isample8>(int32_t x) { return isplat8(x); }
+template <int K> static inline isample4 vshl(const isample4 &x) { return shl4<K>(x); }
+template <int K> static inline isample8 vshl(const isample8 &x) { return shl8<K>(x); }
+template <int K> static inline isample4 vshr(const isample4 &x) { return shr4<K>(x); }
+template <int K> static inline isample8 vshr(const isample8 &x) { return shr8<K>(x); }
+
+static inline isample4 vbits(const sample4 &x) { return bits4(x); }
+static inline isample8 vbits(const sample8 &x) { return bits8(x); }
+static inline sample4 vunbits(const isample4 &x) { return unbits4(x); }
+static inline sample8 vunbits(const isample8 &x) { return unbits8(x); }
+static inline isample4 vtoint(const sample4 &x) { return toint4(x); }
+static inline isample8 vtoint(const sample8 &x) { return toint8(x); }
+static inline sample4 vtofloat(const isample4 &x) { return tofloat4(x); }
+static inline sample8 vtofloat(const isample8 &x) { return tofloat8(x); }
+
+//---------------------------------------------------------------------
+// maths
+//---------------------------------------------------------------------
+
+// Compute sine and cosine of angles 'x' in radians.
+// Equivalent to (but faster than) the unrolled code:
+/*
+for (int i = 0; i < 4; ++i)
+{
+  si[i] = sin(x[i]);
+  co[i] = cos(x[i]);
+}
+*/
+// Reduces to [-pi/4, pi/4] by the nearest multiple of pi/2
+// (pi/2 split in three parts, exact products for |x| < 2^15),
+// then evaluates minimax polynomials (from Cephes sinf/cosf).
+// Maximum absolute error, measured by host/dsp-bench
+// against double precision sin/cos (libm sinf/cosf: 3.3e-08):
+//   |x| <= 2 pi   9.2e-08
+//   |x| <= 1e3    9.3e-08
+//   |x| <= 1e5    9.3e-08 with FMA, 9.6e-07 without
+//   |x| <= 1e7    0.63
+// so keep phases wrapped to a few thousand radians;
+// results stay within [-1, 1] for all finite x (and are meaningless
+// beyond 2^24, where the spacing of floats exceeds pi/2 anyway).
+template <typename V>
+static inline void vsincos(V &si, V &co, const V &x)
+{
+	// nearest quadrant q, remainder r = x - q pi/2
+	V q = vfloor(x * vsplat<V>(0.636619772f) + vsplat<V>(0.5f));
+	V r = x - q * vsplat<V>(1.5703125f);
+	r = r - q * vsplat<V>(4.837512969970703125e-4f);
+	r = r - q * vsplat<V>(7.54978995489188216e-8f);
+	// |r| can slightly exceed pi/4 as q is rounded in float;
+	// clamp to keep the polynomials bounded when q is inexact (huge x)
+	r = vmin(vmax(r, vsplat<V>(-0.9f)), vsplat<V>(0.9f));
+	// sin(r) and cos(r) for |r| <= pi/4
+	V r2 = r * r;
+	V s = r + r * r2 * (vsplat<V>(-1.6666654611e-1f) + r2 * (vsplat<V>(8.3321608736e-3f) + r2 * vsplat<V>(-1.9515295891e-4f)));
+	V c = vsplat<V>(1.0f) - r2 * vsplat<V>(0.5f) + r2 * r2 * (vsplat<V>(4.166664568298827e-2f) + r2 * (vsplat<V>(-1.388731625493765e-3f) + r2 * vsplat<V>(2.443315711809948e-5f)));
+	// quadrant q mod 2 swaps sin and cos, q mod 4 gives the signs
+	// (computed in float to avoid integer vector operations)
+	V q2 = q - vsplat<V>(2.0f) * vfloor(q * vsplat<V>(0.5f));
+	V q4 = q - vsplat<V>(4.0f) * vfloor(q * vsplat<V>(0.25f));
+	V half = vsplat<V>(0.5f);
+	V sq = vselect(q2, half, s, c);
+	V cq = vselect(q2, half, c, s);
+	si = vselect(q4, vsplat<V>(2.0f), sq, vsplat<V>(0.0f) - sq); // q4 in {2, 3}: negate
+	co = vselect(vabs(q4 - vsplat<V>(1.5f)), vsplat<V>(1.0f), vsplat<V>(0.0f) - cq, cq); // q4 in {1, 2}: negate
+}
+
+template <typename V>
+static inline V vsin(const V &x)
+{
+	V si, co;
+	vsincos(si, co, x);
+	return si;
+}
+
+template <typename V>
+static inline V vcos(const V &x)
+{
+	V si, co;
+	vsincos(si, co, x);
+	return co;
+}
+
+static inline void sincos1(float &si, float &co, float x) { sample4 s, c; vsincos(s, c, splat4(x)); si = s[0]; co = c[0]; }
+static inline void sincos4(sample4 &si, sample4 &co, const sample4 &x) { vsincos(si, co, x); }
+static inline void sincos8(sample8 &si, sample8 &co, const sample8 &x) { vsincos(si, co, x); }
+static inline float sin1(float x) { return vsin(splat4(x))[0]; }
+static inline sample4 sin4(const sample4 &x) { return vsin(x); }
+static inline sample8 sin8(const sample8 &x) { return vsin(x); }
+static inline float cos1(float x) { return vcos(splat4(x))[0]; }
+static inline sample4 cos4(const sample4 &x) { return vcos(x); }
+static inline sample8 cos8(const sample8 &x) { return vcos(x); }
+
+// Exponentials and logarithms, for all finite inputs.
+// Split into a power of two (built directly in the exponent bits)
+// and a small remainder for minimax polynomials (from Cephes expf/logf).
+// Maximum relative error, measured by host/dsp-bench
+// against double precision libm (libm expf/exp2f: 6.0e-08):
+//   exp   |x| <= 87   8.5e-08
+//   exp2  |x| <= 126  8.5e-08
+// Maximum absolute error for x in [0.5, 2] (libm logf/log2f: 3.2e-08):
+//   log   4.1e-08
+//   log2  6.5e-08
+// and for all positive normal x, half an ulp of |log(x)| <= 88 as in libm.
+// exp/exp2 overflow to infinity above 2^128;
+// on the SSE/AVX and scalar backends they underflow gradually
+// (through denormals) to zero below 2^-149, but ARMv7 NEON
+// flushes denormals to zero, so there they give 0 below 2^-126;
+// log/log2 give -infinity for x < 2^-126 (zero, denormals and negative x)
+// and +infinity for infinite x.
+// pow(x, y) = exp2(y log2(x)) for x > 0, its relative error grows
+// with |y log2(x)| (8.2e-07 for x in [0, 1] and y = 0.75).
+// NaN inputs give unspecified results.
+
+// exp(r) for |r| <= log(2)/2
+template <typename V>
+static inline V vexpr(const V &r)
+{
+	V p = vsplat<V>(1.9875691500e-4f);
+	p = p * r + vsplat<V>(1.3981999507e-3f);
+	p = p * r + vsplat<V>(8.3334519073e-3f);
+	p = p * r + vsplat<V>(4.1665795894e-2f);
+	p = p * r + vsplat<V>(1.6666665459e-1f);
+	p = p * r + vsplat<V>(5.0000001201e-1f);
+	return p * r * r + r + vsplat<V>(1.0f);
+}
+
+// p * 2^n for integer-valued n in [-252, 254]
+// (2^n is split in two factors, each built in the exponent bits,
+// so that the result can be denormal, where supported, or overflow to infinity)
+template <typename V>
+static inline V vldexp(const V &p, const V &n)
+{
+	V n1 = vfloor(n * vsplat<V>(0.5f));
+	V n2 = n - n1;
+	V s1 = vunbits(vtoint((n1 + vsplat<V>(127.0f)) * vsplat<V>(8388608.0f)));
+	V s2 = vunbits(vtoint((n2 + vsplat<V>(127.0f)) * vsplat<V>(8388608.0f)));
+	return p * s1 * s2;
+}
+
+template <typename V>
+static inline V vexp2(const V &x)
+{
+	V y = vmin(vmax(x, vsplat<V>(-151.0f)), vsplat<V>(129.0f));
+	V n = vfloor(y + vsplat<V>(0.5f));
+	return vldexp(vexpr((y - n) * vsplat<V>(0.693147181f)), n);
+}
+
+template <typename V>
+static inline V vexp(const V &x)
+{
+	V y = vmin(vmax(x, vsplat<V>(-104.0f)), vsplat<V>(89.0f));
+	V n = vfloor(y * vsplat<V>(1.44269504f) + vsplat<V>(0.5f));
+	// log(2) split in two parts, n * 0.693359375 is exact
+	V r = y - n * vsplat<V>(0.693359375f);
+	r = r - n * vsplat<V>(-2.12194440e-4f);
+	return vldexp(vexpr(r), n);
+}
+
+// split x > 0 into x = 2^e (1 + f) with 1 + f in [sqrt(1/2), sqrt(2)),
+// returning e and log(1 + f)
+template <typename V>
+static inline V vlogr(V &e, const V &x)
+{
+	auto b = vbits(x);
+	typedef decltype(b) I;
+	// exponent and mantissa fields (exact conversions)
+	e = vtofloat(b & visplat<I>(0x7f800000)) * vsplat<V>(1.0f / 8388608.0f) - vsplat<V>(127.0f);
+	V m = vunbits((b & visplat<I>(0x007fffff)) | visplat<I>(0x3f800000));
+	V sqrt2 = vsplat<V>(1.41421356f);
+	e = vselect(m, sqrt2, e, e + vsplat<V>(1.0f));
+	m = vselect(m, sqrt2, m, m * vsplat<V>(0.5f));
+	V f = m - vsplat<V>(1.0f);
+	V f2 = f * f;
+	V p = vsplat<V>(7.0376836292e-2f);
+	p = p * f + vsplat<V>(-1.1514610310e-1f);
+	p = p * f + vsplat<V>(1.1676998740e-1f);
+	p = p * f + vsplat<V>(-1.2420140846e-1f);
+	p = p * f + vsplat<V>(1.4249322787e-1f);
+	p = p * f + vsplat<V>(-1.6668057665e-1f);
+	p = p * f + vsplat<V>(2.0000714765e-1f);
+	p = p * f + vsplat<V>(-2.4999993993e-1f);
+	p = p * f + vsplat<V>(3.3333331174e-1f);
+	return f + (p * f * f2 - f2 * vsplat<V>(0.5f));
+}
+
+// results outside the normal range of x
+template <typename V>
+static inline V vlogspecial(const V &l, const V &x)
+{
+	V r = vselect(x, vsplat<V>(1.17549435e-38f), vsplat<V>(-INFINITY), l);
+	return vselect(vsplat<V>(3.40282347e+38f), x, vsplat<V>(INFINITY), r);
+}
+
+template <typename V>
+static inline V vlog(const V &x)
+{
+	V e;
+	V l = vlogr(e, x);
+	// log(2) split in two parts, e * 0.693359375 is exact
+	l = l + e * vsplat<V>(-2.12194440e-4f);
+	l = l + e * vsplat<V>(0.693359375f);
+	return vlogspecial(l, x);
+}
+
+template <typename V>
+static inline V vlog2(const V &x)
+{
+	V e;
+	V l = vlogr(e, x);
+	return vlogspecial(l * vsplat<V>(1.44269504f) + e, x);
+}
+
+template <typename V>
+static inline V vpow(const V &x, const V &y)
+{
+	return vexp2(y * vlog2(x));
+}
+
+static inline float exp1(float x) { return vexp(splat4(x))[0]; }
+static inline sample4 exp4(const sample4 &x) { return vexp(x); }
+static inline sample8 exp8(const sample8 &x) { return vexp(x); }
+static inline float exp2_1(float x) { return vexp2(splat4(x))[0]; }
+static inline sample4 exp2_4(const sample4 &x) { return vexp2(x); }
+static inline sample8 exp2_8(const sample8 &x) { return vexp2(x); }
+static inline float log1(float x) { return vlog(splat4(x))[0]; }
+static inline sample4 log4(const sample4 &x) { return vlog(x); }
+static inline sample8 log8(const sample8 &x) { return vlog(x); }
+static inline float log2_1(float x) { return vlog2(splat4(x))[0]; }
+static inline sample4 log2_4(const sample4 &x) { return vlog2(x); }
+static inline sample8 log2_8(const sample8 &x) { return vlog2(x); }
+static inline float pow1(float x, float y) { return vpow(splat4(x), splat4(y))[0]; }
+static inline sample4 pow4(const sample4 &x, const sample4 &y) { return vpow(x, y); }
+static inline sample8 pow8(const sample8 &x, const sample8 &y) { return vpow(x, y); }
+
+//---------------------------------------------------------------------
+// saturation
+//---------------------------------------------------------------------
+
+// Vector versions of the soft clipping and waveshaping in dsp.h
+// (same approximations, see there for the error bounds).
+
+// Hyperbolic tangent.
+template <typename V>
+static inline V vfasttanh(const V &x)
+{
+	V limit = vsplat<V>(7.90531110763549805f);
+	V y = vmin(vmax(x, vsplat<V>(0.0f) - limit), limit);
+	V y2 = y * y;
+	V p = vsplat<V>(-2.76076847742355e-16f);
+	p = p * y2 + vsplat<V>(2.00018790482477e-13f);
+	p = p * y2 + vsplat<V>(-8.60467152213735e-11f);
+	p = p * y2 + vsplat<V>(5.12229709037114e-08f);
+	p = p * y2 + vsplat<V>(1.48572235717979e-05f);
+	p = p * y2 + vsplat<V>(6.37261928875436e-04f);
+	p = p * y2 + vsplat<V>(4.89352455891786e-03f);
+	V q = vsplat<V>(1.19825839466702e-06f);
+	q = q * y2 + vsplat<V>(1.18534705686654e-04f);
+	q = q * y2 + vsplat<V>(2.26843463243900e-03f);
+	q = q * y2 + vsplat<V>(4.89352518554385e-03f);
+	return y * p * vrecip(q);
+}
+
+// Sine fold sin(pi/2 x).
+template <typename V>
+static inline V vsinefold(const V &x)
+{
+	V one = vsplat<V>(1.0f);
+	V u = x + one;
+	u = u - vsplat<V>(4.0f) * vfloor(u * vsplat<V>(0.25f));
+	V y = vselect(u, vsplat<V>(2.0f), u - one, vsplat<V>(3.0f) - u);
+	V y2 = y * y;
+	V p = vsplat<V>(-3.5988432352120853e-06f);
+	p = p * y2 + vsplat<V>(1.6044118478735982e-04f);
+	p = p * y2 + vsplat<V>(-4.6817541353186881e-03f);
+	p = p * y2 + vsplat<V>(7.9692626246167046e-02f);
+	p = p * y2 + vsplat<V>(-6.4596409750624625e-01f);
+	p = p * y2 + vsplat<V>(1.5707963267948966f);
+	return y * p;
+}
+
+// Cubic soft clip 1.5 x - 0.5 x^3.
+template <typename V>
+static inline V vcubicclip(const V &x)
+{
+	V y = vmin(vmax(x, vsplat<V>(-1.0f)), vsplat<V>(1.0f));
+	return y * (vsplat<V>(1.5f) - vsplat<V>(0.5f) * y * y);
+}
+
+// Asymmetric soft clip tanh(x + bias) - tanh(bias).
+template <typename V>
+static inline V vasymclip(const V &x, const V &bias)
+{
+	return vfasttanh(x + bias) - vfasttanh(bias);
+}
+
+static inline sample4 fasttanh4(const sample4 &x) { return vfasttanh(x); }
+static inline sample8 fasttanh8(const sample8 &x) { return vfasttanh(x); }
+static inline sample4 sinefold4(const sample4 &x) { return vsinefold(x); }
+static inline sample8 sinefold8(const sample8 &x) { return vsinefold(x); }
+static inline sample4 cubicclip4(const sample4 &x) { return vcubicclip(x); }
+static inline sample8 cubicclip8(const sample8 &x) { return vcubicclip(x); }
+static inline sample4 asymclip4(const sample4 &x, const sample4 &bias) { return vasymclip(x, bias); }
+static inline sample8 asymclip8(const sample8 &x, const sample8 &bias) { return vasymclip(x, bias); }
+
+//---------------------------------------------------------------------
+// conversions
+//---------------------------------------------------------------------
+
+// Vector versions of the Pure-data style conversions in dsp.h
+// (same constants and clamping), built on the kernels above.
+// Based on code from Pure-data:
+// pd-0.45-5/src/d_math.c
+
+// Convert MIDI note numbers to frequencies in Hz (A 440).
+template <typename V>
+static inline V vmtof(const V &f)
+{
+	return vexp(vmin(f, vsplat<V>(1499.0f)) * vsplat<V>(0.0577622650f)) * vsplat<V>(8.17579891564f);
+}
+
+// Convert frequencies in Hz to MIDI note numbers.
+template <typename V>
+static inline V vftom(const V &f)
+{
+	return vlog(f * vsplat<V>(0.12231220585f)) * vsplat<V>(17.3123405046f);
+}
+
+// Convert decibels (where 100 = full scale) to audio level (RMS).
+template <typename V>
+static inline V vdbtorms(const V &f)
+{
+	return vexp((vmin(f, vsplat<V>(870.0f)) - vsplat<V>(100.0f)) * vsplat<V>(0.5f * float(log10overten)));
+}
+
+// Convert audio level (RMS) to decibels (where 100 = full scale).
+template <typename V>
+static inline V vrmstodb(const V &f)
+{
+	return vsplat<V>(100.0f) + vlog(f) * vsplat<V>(2.0f * float(tenoverlog10));
+}
+
+// Convert decibels (where 100 = full scale) to audio power.
+template <typename V>
+static inline V vdbtopow(const V &f)
+{
+	return vexp((vmin(f, vsplat<V>(485.0f)) - vsplat<V>(100.0f)) * vsplat<V>(float(log10overten)));
+}
+
+// Convert audio power to decibels (where 100 = full scale).
+template <typename V>
+static inline V vpowtodb(const V &f)
+{
+	return vsplat<V>(100.0f) + vlog(f) * vsplat<V>(float(tenoverlog10));
+}
+
+// Reduce the precision of 'x' to 'bits'-many bits,
+// considered as a fixed point number.
+// Unlike dsp.h bitcrush(), halves always round up.
+template <typename V>
+static inline V vbitcrush(const V &x, const V &bits)
+{
+	V n = vexp2(bits);
+	return vfloor(x * n + vsplat<V>(0.5f)) / n;
+}
+
+static inline sample4 mtof4(const sample4 &f) { return vmtof(f); }
+static inline sample8 mtof8(const sample8 &f) { return vmtof(f); }
+static inline sample4 ftom4(const sample4 &f) { return vftom(f); }
+static inline sample8 ftom8(const sample8 &f) { return vftom(f); }
+static inline sample4 dbtorms4(const sample4 &f) { return vdbtorms(f); }
+static inline sample8 dbtorms8(const sample8 &f) { return vdbtorms(f); }
+static inline sample4 rmstodb4(const sample4 &f) { return vrmstodb(f); }
+static inline sample8 rmstodb8(const sample8 &f) { return vrmstodb(f); }
+static inline sample4 dbtopow4(const sample4 &f) { return vdbtopow(f); }
+static inline sample8 dbtopow8(const sample8 &f) { return vdbtopow(f); }
+static inline sample4 powtodb4(const sample4 &f) { return vpowtodb(f); }
+static inline sample8 powtodb8(const sample8 &f) { return vpowtodb(f); }
+static inline sample4 bitcrush4(const sample4 &x, const sample4 &bits) { return vbitcrush(x, bits); }
+static inline sample8 bitcrush8(const sample8 &x, const sample8 &bits) { return vbitcrush(x, bits); }
+
+//---------------------------------------------------------------------
+// block versions, for arrays of 'n' values (any n, 8 at a time)
+// output 'y' may be the same array as input 'x'
+
+// Apply the kernel K (a struct with a template operator())
+// to an array, 8 at a time, then 4, then one.
+template <typename K>
+static inline void vblock(float *y, const float *x, int n)
+{
+	K k;
+	int i = 0;
+	for (; i + 8 <= n; i += 8)
+	{
+		vstore(y + i, k(vload<sample8>(x + i)));
+	}
+	for (; i + 4 <= n; i += 4)
+	{
+		vstore(y + i, k(vload<sample4>(x + i)));
+	}
+	for (; i < n; ++i)
+	{
+		y[i] = k(splat4(x[i]))[0];
+	}
+}
+
+#define SIMD_BLOCK(name, kernel) \
+	struct SIMD_BLOCK_##name { template <typename V> V operator()(const V &x) const { return kernel(x); } }; \
+	static inline void name(float *y, const float *x, int n) { vblock<SIMD_BLOCK_##name>(y, x, n); }
+
+SIMD_BLOCK(exp_block, vexp)
+SIMD_BLOCK(exp2_block, vexp2)
+SIMD_BLOCK(log_block, vlog)
+SIMD_BLOCK(log2_block, vlog2)
+SIMD_BLOCK(sin_block, vsin)
+SIMD_BLOCK(cos_block, vcos)
+
+// Sine and cosine of 'n' angles 'x' (output arrays must not overlap 'x').
+static inline void sincos_block(float *si, float *co, const float *x, int n)
+{
+	int i = 0;
+	for (; i + 8 <= n; i += 8)
+	{
+		sample8 s, c;
+		vsincos(s, c, load8(x + i));
+		store8(si + i, s);
+		store8(co + i, c);
+	}
+	for (; i < n; ++i)
+	{
+		sincos1(si[i], co[i], x[i]);
+	}
+}
+
+SIMD_BLOCK(fasttanh_block, vfasttanh)
+SIMD_BLOCK(sinefold_block, vsinefold)
+SIMD_BLOCK(cubicclip_block, vcubicclip)
+
+// Asymmetric soft clip of 'n' values, with common 'bias'.
+static inline void asymclip_block(float *y, const float *x, int n, float bias)
+{
+	sample8 b8 = splat8(bias);
+	sample4 b4 = splat4(bias);
+	int i = 0;
+	for (; i + 8 <= n; i += 8)
+	{
+		store8(y + i, vasymclip(load8(x + i), b8));
+	}
+	for (; i < n; ++i)
+	{
+		y[i] = vasymclip(splat4(x[i]), b4)[0];
+	}
+}
+
+SIMD_BLOCK(mtof_block, vmtof)
+SIMD_BLOCK(ftom_block, vftom)
+SIMD_BLOCK(dbtorms_block, vdbtorms)
+SIMD_BLOCK(rmstodb_block, vrmstodb)
+SIMD_BLOCK(dbtopow_block, vdbtopow)
+SIMD_BLOCK(powtodb_block, vpowtodb)
+
+//---------------------------------------------------------------------
+// random numbers
+//---------------------------------------------------------------------
+
+// 4 or 8 independent xoshiro128+ generators, one per element,
+// see dsp.h rng_next() for a non-vectorized implementation.
+// Lane 'k' is seeded differently from every other lane,
+// so the lanes give unrelated sequences.
+typedef struct { uint32_t s0[4], s1[4], s2[4], s3[4]; } RNG4;
+typedef struct { uint32_t s0[8], s1[8], s2[8], s3[8]; } RNG8;
+
+static inline void vrng_seed(uint32_t *s0, uint32_t *s1, uint32_t *s2, uint32_t *s3, int lanes, uint64_t seed)
+{
+	for (int k = 0; k < lanes; ++k)
+	{
+		RNG r;
+		rng_seed(&r, seed + k * 0x632be59bd9b4e019ull);
+		s0[k] = r.s[0];
+		s1[k] = r.s[1];
+		s2[k] = r.s[2];
+		s3[k] = r.s[3];
+	}
+}
+
+static inline void rng4_seed(RNG4 *r, uint64_t seed) { vrng_seed(r->s0, r->s1, r->s2, r->s3, 4, seed); }
+static inline void rng8_seed(RNG8 *r, uint64_t seed) { vrng_seed(r->s0, r->s1, r->s2, r->s3, 8, seed); }
+
+// Generator state in registers, for the kernels below.
+template <typename I>
+struct VRNG
+{
+	I s0, s1, s2, s3;
+	void load(const uint32_t *p0, const uint32_t *p1, const uint32_t *p2, const uint32_t *p3)
+	{
+		memcpy(&s0, p0, sizeof(I));
+		memcpy(&s1, p1, sizeof(I));
+		memcpy(&s2, p2, sizeof(I));
+		memcpy(&s3, p3, sizeof(I));
+	}
+	void store(uint32_t *p0, uint32_t *p1, uint32_t *p2, uint32_t *p3) const
+	{
+		memcpy(p0, &s0, sizeof(I));
+		memcpy(p1, &s1, sizeof(I));
+		memcpy(p2, &s2, sizeof(I));
+		memcpy(p3, &s3, sizeof(I));
+	}
+	// next 32 random bits per element
+	I next()
+	{
+		I result = s0 + s3;
+		I t = vshl<9>(s1);
+		s2 = s2 ^ s0;
+		s3 = s3 ^ s1;
+		s1 = s1 ^ s2;
+		s0 = s0 ^ s3;
+		s2 = s2 ^ t;
+		s3 = vshl<11>(s3) | vshr<21>(s3);
+		return result;
+	}
+};
+
+// Uniform in the range -1 (inclusive) to +1, from random bits.
+template <typename V, typename I>
+static inline V vrng_uniform(const I &x)
+{
+	return vtofloat(x) * vsplat<V>(4.656612873077392578125e-10f); // 2^-31
+}
+
+// Two normally distributed values, mean 0 and standard deviation 1,
+// from random bits (Box-Muller transform).
+template <typename V, typename I>
+static inline void vrng_gaussian(V &g0, V &g1, const I &x, const I &y)
+{
+	V u = (vtofloat(vshr<8>(x)) + vsplat<V>(1.0f)) * vsplat<V>(5.9604644775390625e-8f); // 0 < u <= 1
+	V v = vrng_uniform<V>(y) * vsplat<V>(float(M_PI));
+	V r = vexp(vsplat<V>(0.5f) * vlog(vsplat<V>(-2.0f) * vlog(u))); // sqrt(-2 log(u))
+	V si, co;
+	vsincos(si, co, v);
+	g0 = r * co;
+	g1 = r * si;
+}
+
+static inline sample4 rng4_uniform(RNG4 *r)
+{
+	VRNG<isample4> g;
+	g.load(r->s0, r->s1, r->s2, r->s3);
+	sample4 y = vrng_uniform<sample4>(g.next());
+	g.store(r->s0, r->s1, r->s2, r->s3);
+	return y;
+}
+
+static inline sample8 rng8_uniform(RNG8 *r)
+{
+	VRNG<isample8> g;
+	g.load(r->s0, r->s1, r->s2, r->s3);
+	sample8 y = vrng_uniform<sample8>(g.next());
+	g.store(r->s0, r->s1, r->s2, r->s3);
+	return y;
+}
+
+static inline sample4 rng4_gaussian(RNG4 *r)
+{
+	VRNG<isample4> g;
+	g.load(r->s0, r->s1, r->s2, r->s3);
+	isample4 x = g.next(), y = g.next();
+	g.store(r->s0, r->s1, r->s2, r->s3);
+	sample4 g0, g1;
+	vrng_gaussian(g0, g1, x, y);
+	return g0;
+}
+
+static inline sample8 rng8_gaussian(RNG8 *r)
+{
+	VRNG<isample8> g;
+	g.load(r->s0, r->s1, r->s2, r->s3);
+	isample8 x = g.next(), y = g.next();
+	g.store(r->s0, r->s1, r->s2, r->s3);
+	sample8 g0, g1;
+	vrng_gaussian(g0, g1, x, y);
+	return g0;
+}
+
+// Fill 'n' values with uniformly distributed white noise,
+// in the range -1 (inclusive) to +1.
+static inline void rng_uniform_block(RNG8 *r, float *y, int n)
+{
+	VRNG<isample8> g;
+	g.load(r->s0, r->s1, r->s2, r->s3);
+	int i = 0;
+	for (; i + 8 <= n; i += 8)
+	{
+		store8(y + i, vrng_uniform<sample8>(g.next()));
+	}
+	if (i < n)
+	{
+		float t[8];
+		store8(t, vrng_uniform<sample8>(g.next()));
+		memcpy(y + i, t, (n - i) * sizeof(*y));
+	}
+	g.store(r->s0, r->s1, r->s2, r->s3);
+}
+
+// Fill 'n' values with normally distributed white noise,
+// mean 0 and standard deviation 1
+// (both outputs of each Box-Muller transform are used).
+static inline void rng_gaussian_block(RNG8 *r, float *y, int n)
+{
+	VRNG<isample8> g;
+	g.load(r->s0, r->s1, r->s2, r->s3);
+	for (int i = 0; i < n; i += 16)
+	{
+		isample8 a = g.next(), b = g.next();
+		sample8 g0, g1;
+		vrng_gaussian(g0, g1, a, b);
+		if (i + 16 <= n)
+		{
+			store8(y + i, g0);
+			store8(y + i + 8, g1);
+		}
+		else
+		{
+			float t[16];
+			store8(t, g0);
+			store8(t + 8, g1);
+			memcpy(y + i, t, (n - i) * sizeof(*y));
+		}
+	}
+	g.store(r->s0, r->s1, r->s2, r->s3);
+}
+
+//---------------------------------------------------------------------
+// oscillators
+//---------------------------------------------------------------------
+
+// Banks of 4 or 8 oscillators with 32bit integer phase accumulators,
+// see dsp.h phasor32() for a non-vectorized phasor.
+// One cycle is 2^32, so phases wrap exactly by integer overflow.
+// Each call advances every oscillator by one sample
+// at its frequency 'hz' (-SR/2 < hz < SR/2),
+// and returns its waveform at its phase plus its 'phase' offset
+// (in cycles, -128 < phase < 128), times its 'amplitude'.
+// Waveforms start at 0 rising (sine, triangle) or at the jump (saw, pulse),
+// saw and pulse are band-limited with polyBLEP;
+// triangle is not, its aliases are 12dB/octave weaker than saw's.
+typedef struct { uint32_t phase[4]; } OSC4;
+typedef struct { uint32_t phase[8]; } OSC8;
+
+// Convert cycles to 32bit phase (wrapping).
+template <typename V>
+static inline auto vphase32(const V &cycles) -> decltype(vtoint(cycles))
+{
+	return vshl<8>(vtoint(cycles * vsplat<V>(16777216.0f))); // 2^24
+}
+
+// Convert 32bit phase to the range 0 to 1.
+template <typename V, typename I>
+static inline V vunit32(const I &p)
+{
+	return vtofloat(vshr<8>(p)) * vsplat<V>(5.9604644775390625e-8f); // 2^-24
+}
+
+// polyBLEP residual for a downwards jump of 2 at t = 0,
+// with phase increment 'dt' (and its reciprocal 'idt').
+template <typename V>
+static inline V vpolyblep(const V &t, const V &dt, const V &idt)
+{
+	V one = vsplat<V>(1.0f);
+	V x0 = t * idt; // just after the jump
+	V b0 = x0 + x0 - x0 * x0 - one;
+	V x1 = (t - one) * idt; // just before the jump
+	V b1 = x1 * x1 + x1 + x1 + one;
+	return vselect(t, dt, b0, vselect(one - dt, t, b1, vsplat<V>(0.0f)));
+}
+
+// Waveforms of phase 'p', with increment 'dt' (and reciprocal 'idt')
+// and pulse width 'w' (as 32bit phase), in the range -1 to 1.
+
+struct OSC_SINE
+{
+	template <typename V, typename I>
+	V operator()(const I &p, const V &, const V &, const I &) const
+	{
+		return vsin(vtofloat(p) * vsplat<V>(1.4629180792671596e-09f)); // pi / 2^31
+	}
+};
+
+struct OSC_SAW
+{
+	template <typename V, typename I>
+	V operator()(const I &p, const V &dt, const V &idt, const I &) const
+	{
+		V t = vunit32<V>(p);
+		return t + t - vsplat<V>(1.0f) - vpolyblep(t, dt, idt);
+	}
+};
+
+struct OSC_PULSE
+{
+	template <typename V, typename I>
+	V operator()(const I &p, const V &dt, const V &idt, const I &w) const
+	{
+		// difference of two saws, +1 for t < w, -1 after
+		V t = vunit32<V>(p);
+		V u = vunit32<V>(p - w);
+		V s = u - t + vunit32<V>(w);
+		return s + s - vsplat<V>(1.0f) - vpolyblep(u, dt, idt) + vpolyblep(t, dt, idt);
+	}
+};
+
+struct OSC_TRIANGLE
+{
+	template <typename V, typename I>
+	V operator()(const I &p, const V &, const V &, const I &) const
+	{
+		V t = vunit32<V>(p + visplat<I>(1 << 30)) - vsplat<V>(0.5f); // quarter cycle ahead
+		return vsplat<V>(1.0f) - vsplat<V>(4.0f) * vabs(t);
+	}
+};
+
+// Advance the phases and evaluate the waveform kernel 'k'
+// (one of the above, or another such as OSC_WAVETABLE in wavetable.h).
+template <typename K, typename V>
+static inline V vosc(const K &k, uint32_t *phase, const V &hz, const V &offset, const V &amplitude, const V &width)
+{
+	auto p = vtoint(hz); // for the integer vector type
+	memcpy(&p, phase, sizeof(p));
+	p = p + vtoint(hz * vsplat<V>(rate().pincf));
+	memcpy(phase, &p, sizeof(p));
+	V dt = vabs(hz) * vsplat<V>(rate().isrf);
+	V idt = vrecip(vmax(dt, vsplat<V>(1.0e-9f)));
+	return amplitude * k(p + vphase32(offset), dt, idt, vphase32(width));
+}
+
+static inline sample4 osc4_sine(OSC4 *o, const sample4 &hz, const sample4 &phase, const sample4 &amplitude) { return vosc(OSC_SINE(), o->phase, hz, phase, amplitude, hz); }
+static inline sample8 osc8_sine(OSC8 *o, const sample8 &hz, const sample8 &phase, const sample8 &amplitude) { return vosc(OSC_SINE(), o->phase, hz, phase, amplitude, hz); }
+static inline sample4 osc4_saw(OSC4 *o, const sample4 &hz, const sample4 &phase, const sample4 &amplitude) { return vosc(OSC_SAW(), o->phase, hz, phase, amplitude, hz); }
+static inline sample8 osc8_saw(OSC8 *o, const sample8 &hz, const sample8 &phase, const sample8 &amplitude) { return vosc(OSC_SAW(), o->phase, hz, phase, amplitude, hz); }
+static inline sample4 osc4_triangle(OSC4 *o, const sample4 &hz, const sample4 &phase, const sample4 &amplitude) { return vosc(OSC_TRIANGLE(), o->phase, hz, phase, amplitude, hz); }
+static inline sample8 osc8_triangle(OSC8 *o, const sample8 &hz, const sample8 &phase, const sample8 &amplitude) { return vosc(OSC_TRIANGLE(), o->phase, hz, phase, amplitude, hz); }
+// 'width' is the fraction of each cycle at +1 (0 < width < 1)
+static inline sample4 osc4_pulse(OSC4 *o, const sample4 &hz, const sample4 &phase, const sample4 &amplitude, const sample4 &width) { return vosc(OSC_PULSE(), o->phase, hz, phase, amplitude, width); }
+static inline sample8 osc8_pulse(OSC8 *o, const sample8 &hz, const sample8 &phase, const sample8 &amplitude, const sample8 &width) { return vosc(OSC_PULSE(), o->phase, hz, phase, amplitude, width); }
+
+// Block versions for large banks: 'banks' OSC8 (8 * banks voices)
+// with per-voice parameters in arrays of 8 * banks values,
+// held constant for the block of 'n' samples.
+// The sum of all voices is added to 'y' (which is not cleared first).
+// Each bank keeps its phases and parameters in registers for the block.
+template <typename K>
+static inline void vosc_block(const K &k, OSC8 *o, int banks, const float *hz, const float *phase, const float *amplitude, const float *width, float *y, int n)
+{
+	for (int b = 0; b < banks; ++b)
+	{
+		sample8 f = load8(hz + 8 * b);
+		sample8 a = load8(amplitude + 8 * b);
+		isample8 offset = vphase32(load8(phase + 8 * b));
+		isample8 w = width ? vphase32(load8(width + 8 * b)) : isplat8(0);
+		isample8 inc = vtoint(f * splat8(rate().pincf));
+		sample8 dt = vabs(f) * splat8(rate().isrf);
+		sample8 idt = vrecip(vmax(dt, splat8(1.0e-9f)));
+		isample8 p;
+		memcpy(&p, o[b].phase, sizeof(p));
+		for (int i = 0; i < n; ++i)
+		{
+			p = p + inc;
+			y[i] += vsum(a * k(p + offset, dt, idt, w));
+		}
+		memcpy(o[b].phase, &p, sizeof(p));
+	}
+}
+
+static inline void osc_sine_block(OSC8 *o, int banks, const float *hz, const float *phase, const float *amplitude, float *y, int n) { vosc_block(OSC_SINE(), o, banks, hz, phase, amplitude, nullptr, y, n); }
+static inline void osc_saw_block(OSC8 *o, int banks, const float *hz, const float *phase, const float *amplitude, float *y, int n) { vosc_block(OSC_SAW(), o, banks, hz, phase, amplitude, nullptr, y, n); }
+static inline void osc_triangle_block(OSC8 *o, int banks, const float *hz, const float *phase, const float *amplitude, float *y, int n) { vosc_block(OSC_TRIANGLE(), o, banks, hz, phase, amplitude, nullptr, y, n); }
+static inline void osc_pulse_block(OSC8 *o, int banks, const float *hz, const float *phase, const float *amplitude, const float *width, float *y, int n) { vosc_block(OSC_PULSE(), o, banks, hz, phase, amplitude, width, y, n); }
+
+// Banks of 4 or 8 retriggered complex oscillators:
+// each voice is a complex number multiplied every sample
+// by 'decay' times a rotation by 'angle' (in radians per sample),
+// ringing as a decaying sinusoid (real and imaginary parts in quadrature).
+// Its squared magnitude is followed by an envelope
+// ('rms' += 0.01 * (|z|^2 - 'rms')), and whenever that falls below
+// 'threshold' the voice is retriggered by adding the 'trigger' offset.
+// Voices with decay 1 (to within rounding) ring forever at the magnitude they had
+// after their last retrigger ('level'), and are renormalised to it
+// once per call to cosc_block(), so that rounding (of the increment
+// in particular) does not make them drift louder or quieter.
+// Structure of arrays: one vector step updates 4 or 8 voices.
+typedef struct { float re[4], im[4], incre[4], incim[4], trigre[4], trigim[4], rms[4], level[4]; } COSC4;
+typedef struct { float re[8], im[8], incre[8], incim[8], trigre[8], trigim[8], rms[8], level[8]; } COSC8;
+
+// One sample for the voices 're' + i 'im', with increment 'incre' + i 'incim',
+// trigger 'trigre' + i 'trigim', envelope 'rms' and squared magnitude
+// after the last retrigger 'level'.
+template <typename V>
+static inline void vcosc(V &re, V &im, const V &incre, const V &incim, const V &trigre, const V &trigim, V &rms, V &level, const V &threshold)
+{
+	V zero = vsplat<V>(0.0f);
+	rms = rms + vsplat<V>(0.01f) * (re * re + im * im - rms);
+	re = re + vselect(rms, threshold, trigre, zero);
+	im = im + vselect(rms, threshold, trigim, zero);
+	level = vselect(rms, threshold, re * re + im * im, level);
+	V r = re * incre - im * incim;
+	im = re * incim + im * incre;
+	re = r;
+}
+
+// Renormalise voices with decay 1 to squared magnitude 'level'.
+template <typename V>
+static inline void vcosc_renormalise(V &re, V &im, const V &incre, const V &incim, const V &level)
+{
+	V one = vsplat<V>(1.0f);
+	V m = re * re + im * im;
+	// one Newton step towards sqrt(level / m), enough as drift is slow,
+	// clamped so that a voice far from its level is not negated or blown up
+	V g = vsplat<V>(1.5f) - vsplat<V>(0.5f) * m * vrecip(vmax(level, vsplat<V>(1.0e-30f)));
+	g = vmin(vmax(g, vsplat<V>(0.5f)), vsplat<V>(1.5f));
+	// only for decay 1 (to rounding): |increment|^2 within 2^-20 of 1
+	V d = vabs(incre * incre + incim * incim - one);
+	g = vselect(d, vsplat<V>(1.0f / 1048576.0f), g, one);
+	re = re * g;
+	im = im * g;
+}
+
+// Set the increments from per-voice 'decay' and 'angle'.
+template <typename V>
+static inline void vcosc_tune(float *incre, float *incim, const V &decay, const V &angle)
+{
+	V s, c;
+	vsincos(s, c, angle);
+	vstore(incre, decay * c);
+	vstore(incim, decay * s);
+}
+
+static inline void cosc4_tune(COSC4 *o, const sample4 &decay, const sample4 &angle) { vcosc_tune(o->incre, o->incim, decay, angle); }
+static inline void cosc8_tune(COSC8 *o, const sample8 &decay, const sample8 &angle) { vcosc_tune(o->incre, o->incim, decay, angle); }
+// set the trigger offsets to 'amplitude' rotated by 'angle'
+static inline void cosc4_trigger(COSC4 *o, const sample4 &amplitude, const sample4 &angle) { vcosc_tune(o->trigre, o->trigim, amplitude, angle); }
+static inline void cosc8_trigger(COSC8 *o, const sample8 &amplitude, const sample8 &angle) { vcosc_tune(o->trigre, o->trigim, amplitude, angle); }
+
+// Advance the voices by one sample, returning them in 're' and 'im'.
+template <typename V>
+static inline void vcosc_step(float *pre, float *pim, const float *pincre, const float *pincim, const float *ptrigre, const float *ptrigim, float *prms, float *plevel, float threshold, V &re, V &im)
+{
+	re = vload<V>(pre);
+	im = vload<V>(pim);
+	V rms = vload<V>(prms);
+	V level = vload<V>(plevel);
+	vcosc(re, im, vload<V>(pincre), vload<V>(pincim), vload<V>(ptrigre), vload<V>(ptrigim), rms, level, vsplat<V>(threshold));
+	vstore(pre, re);
+	vstore(pim, im);
+	vstore(prms, rms);
+	vstore(plevel, level);
+}
+
+static inline void cosc4(COSC4 *o, float threshold, sample4 &re, sample4 &im) { vcosc_step(o->re, o->im, o->incre, o->incim, o->trigre, o->trigim, o->rms, o->level, threshold, re, im); }
+static inline void cosc8(COSC8 *o, float threshold, sample8 &re, sample8 &im) { vcosc_step(o->re, o->im, o->incre, o->incim, o->trigre, o->trigim, o->rms, o->level, threshold, re, im); }
+
+// Block versions for large banks: 'banks' COSC8 (8 * banks voices)
+// with per-voice parameters in arrays of 8 * banks values.
+static inline void cosc_tune_block(COSC8 *o, int banks, const float *decay, const float *angle)
+{
+	for (int b = 0; b < banks; ++b)
+	{
+		cosc8_tune(&o[b], load8(decay + 8 * b), load8(angle + 8 * b));
+	}
+}
+
+static inline void cosc_trigger_block(COSC8 *o, int banks, const float *amplitude, const float *angle)
+{
+	for (int b = 0; b < banks; ++b)
+	{
+		cosc8_trigger(&o[b], load8(amplitude + 8 * b), load8(angle + 8 * b));
+	}
+}
+
+// Advance all voices by 'n' samples, adding the sum of the voices
+// to 're' and 'im' (which are not cleared first), then renormalise.
+// Each bank keeps its state in registers for the block.
+static inline void cosc_block(COSC8 *o, int banks, float threshold, float *re, float *im, int n)
+{
+	sample8 t = splat8(threshold);
+	for (int b = 0; b < banks; ++b)
+	{
+		sample8 zre = load8(o[b].re), zim = load8(o[b].im), rms = load8(o[b].rms), level = load8(o[b].level);
+		sample8 incre = load8(o[b].incre), incim = load8(o[b].incim);
+		sample8 trigre = load8(o[b].trigre), trigim = load8(o[b].trigim);
+		for (int i = 0; i < n; ++i)
+		{
+			vcosc(zre, zim, incre, incim, trigre, trigim, rms, level, t);
+			re[i] += vsum(zre);
+			im[i] += vsum(zim);
+		}
+		vcosc_renormalise(zre, zim, incre, incim, level);
+		store8(o[b].re, zre);
+		store8(o[b].im, zim);
+		store8(o[b].rms, rms);
+		store8(o[b].level, level);
+	}
+}
+
+//---------------------------------------------------------------------
+// filters
+//---------------------------------------------------------------------
+
+//---------------------------------------------------------------------
+// Variable cutoff filter, based on pd's [vcf~].
+// See dsp.h vcff() for a non-vectorized implementation.
+
+// 4 or 8 parallel bandpass resonators (4 or 8 inputs and outputs).
+// 4 or 8 different frequencies, all same Q-factor.
+
+// Filter state.
+typedef struct { float re[4], im[4]; } VCF4;
+typedef struct { float re[8], im[8]; } VCF8;
+
+// Filter function.
+// Input signals 'x'.
+// Filter frequencies 'hz' in Hz.
+// One common filter q-factor 'q'.
+template <typename V>
+static inline V vvcf(float *s_re, float *s_im, const V &x, const V &hz, const sample &q)
+{
+	// precondition: 0 < q, 0 <= hz < rate().sr
+	// q is scalar, have not yet needed vector version
+	sample qinv = 1 / q;
+	sample ampcorrect = 2 - 2 / (q + 2);
+	V cf = hz * vsplat<V>(rate().wf); // cf = hz * 2 pi / sample rate
+	V one = vsplat<V>(1.0f); // one = 1
+	V r = one - cf * vsplat<V>(qinv); // r = 1 - cf * qinv
+	r = vmax(r, vsplat<V>(0.0f)); // r = max(r, 0)
+	V oneminusr = one - r; // oneminusr = 1 - r
+	V cre, cim;
+	vsincos(cim, cre, cf); // cim = sin(cf), cre = cos(cf)
+	cre = cre * r; // cre *= r
+	cim = cim * r; // cim *= r
+	V re2 = vload<V>(s_re); // load re from filter state
+	V im2 = vload<V>(s_im); // load im from filter state
+	// re = ampcorrect * oneminusr * x + cre *re2 - cim * im2
+	V re = oneminusr * x * vsplat<V>(ampcorrect) + (cre * re2 - cim * im2);
+	// im = cim * re2 + cre * im2
+	V im = cim * re2 + cre * im2;
+	vstore(s_re, re); // store re to filter state
+	vstore(s_im, im); // store im to filter state
+	return re;
+}
+
+static inline sample4 vcf4(VCF4 *s, const sample4 &x, const sample4 &hz, const sample &q) { return vvcf(s->re, s->im, x, hz, q); }
+static inline sample8 vcf8(VCF8 *s, const sample8 &x, const sample8 &hz, const sample &q) { return vvcf(s->re, s->im, x, hz, q); }
+
+//---------------------------------------------------------------------
+// Biquad bank, see dsp.h biquad() for a non-vectorized implementation.
+
+// 4 or 8 parallel biquads (transposed direct form II, float),
+// each lane with its own coefficients (4 or 8 different filters
+// of one signal, or the same filter on 4 or 8 channels).
+// Coefficients can be shared between banks of state.
+
+// Filter coefficients, one per lane.
+typedef struct { float b0[4], b1[4], b2[4], a1[4], a2[4]; } BIQUAD4_COEFFS;
+typedef struct { float b0[8], b1[8], b2[8], a1[8], a2[8]; } BIQUAD8_COEFFS;
+
+// Filter state, one per lane.
+typedef struct { float s1[4], s2[4]; } BIQUAD4_STATE;
+typedef struct { float s1[8], s2[8]; } BIQUAD8_STATE;
+
+// Set the coefficients of one lane
+// (for example from dsp.h lowpass() etc).
+static inline void biquad4_set(BIQUAD4_COEFFS *c, int lane, const BIQUAD_COEFFS *d)
+{
+	c->b0[lane] = d->b0;
+	c->b1[lane] = d->b1;
+	c->b2[lane] = d->b2;
+	c->a1[lane] = d->a1;
+	c->a2[lane] = d->a2;
+}
+
+static inline void biquad8_set(BIQUAD8_COEFFS *c, int lane, const BIQUAD_COEFFS *d)
+{
+	c->b0[lane] = d->b0;
+	c->b1[lane] = d->b1;
+	c->b2[lane] = d->b2;
+	c->a1[lane] = d->a1;
+	c->a2[lane] = d->a2;
+}
+
+// Filter function, one input per lane.
+template <typename V>
+static inline V vbiquad(const float *b0, const float *b1, const float *b2, const float *a1, const float *a2, float *s1, float *s2, const V &x)
+{
+	V y = vload<V>(b0) * x + vload<V>(s1);
+	vstore(s1, vload<V>(b1) * x - vload<V>(a1) * y + vload<V>(s2));
+	vstore(s2, vload<V>(b2) * x - vload<V>(a2) * y);
+	return y;
+}
+
+static inline sample4 biquad4(const BIQUAD4_COEFFS *c, BIQUAD4_STATE *s, const sample4 &x) { return vbiquad(c->b0, c->b1, c->b2, c->a1, c->a2, s->s1, s->s2, x); }
+static inline sample8 biquad8(const BIQUAD8_COEFFS *c, BIQUAD8_STATE *s, const sample8 &x) { return vbiquad(c->b0, c->b1, c->b2, c->a1, c->a2, s->s1, s->s2, x); }
+
+// Block filter function, 'n' frames of 4 or 8 interleaved channels
+// from 'x' to 'y' (which may be the same array),
+// keeping coefficients and state in registers for the whole block.
+template <typename V>
+static inline void vbiquad_block(const float *b0, const float *b1, const float *b2, const float *a1, const float *a2, float *s1, float *s2, float *y, const float *x, int n, int width)
+{
+	V c0 = vload<V>(b0), c1 = vload<V>(b1), c2 = vload<V>(b2), d1 = vload<V>(a1), d2 = vload<V>(a2);
+	V t1 = vload<V>(s1), t2 = vload<V>(s2);
+	for (int i = 0; i < n; ++i)
+	{
+		V u = vload<V>(x + i * width);
+		V v = c0 * u + t1;
+		t1 = c1 * u - d1 * v + t2;
+		t2 = c2 * u - d2 * v;
+		vstore(y + i * width, v);
+	}
+	vstore(s1, t1);
+	vstore(s2, t2);
+}
+
+static inline void biquad4_block(const BIQUAD4_COEFFS *c, BIQUAD4_STATE *s, float *y, const float *x, int n) { vbiquad_block<sample4>(c->b0, c->b1, c->b2, c->a1, c->a2, s->s1, s->s2, y, x, n, 4); }
+static inline void biquad8_block(const BIQUAD8_COEFFS *c, BIQUAD8_STATE *s, float *y, const float *x, int n) { vbiquad_block<sample8>(c->b0, c->b1, c->b2, c->a1, c->a2, s->s1, s->s2, y, x, n, 8); }
+
+//---------------------------------------------------------------------
+// delay
+//---------------------------------------------------------------------
+
+// Multi-tap reads from a masked delay line, one tap per element,
+// at 'ms' milliseconds behind the write index.
+// See dsp.h mdelread1/2/4() for non-vectorized implementations.
+// There is no fast gather on NEON, so the taps are loaded one by one,
+// but the index and interpolation arithmetic is vectorized.
+
+// Gather 'buffer[r[k] & mask]' into element 'k'.
+template <typename V, typename I>
+static inline V vgather(const float *buffer, const I &r, int mask)
+{
+	I i = r & visplat<I>(mask);
+	V y = vsplat<V>(0.0f);
+	for (int k = 0; k < int(sizeof(V) / sizeof(float)); ++k)
+	{
+		y[k] = buffer[i[k]];
+	}
+	return y;
+}
+
+template <typename V>
+static inline V vmdelread1(const MDELAY *del, const V &ms)
+{
+	const float *buffer = (const float *) (del + 1);
+	auto d = vtoint(ms * vsplat<V>(rate().spmsf)); // convert milliseconds to samples
+	typedef decltype(d) I;
+	return vgather<V>(buffer, visplat<I>(del->woffset) - d, del->mask);
+}
+
+template <typename V>
+static inline V vmdelread2(const MDELAY *del, const V &ms)
+{
+	const float *buffer = (const float *) (del + 1);
+	V d = ms * vsplat<V>(rate().spmsf); // convert milliseconds to samples
+	auto d0 = vtoint(d); // rounds down, as valid delay times are positive
+	typedef decltype(d0) I;
+	V t = d - vtofloat(d0); // fractional distance through range
+	I r0 = visplat<I>(del->woffset) - d0; // relative to write index
+	V y0 = vgather<V>(buffer, r0, del->mask);
+	V y1 = vgather<V>(buffer, r0 - visplat<I>(1), del->mask);
+	return y0 + t * (y1 - y0); // linear interpolation
+}
+
+template <typename V>
+static inline V vmdelread4(const MDELAY *del, const V &ms)
+{
+	const float *buffer = (const float *) (del + 1);
+	V d = ms * vsplat<V>(rate().spmsf); // convert milliseconds to samples
+	auto d1 = vtoint(d); // rounds down, as valid delay times are positive
+	typedef decltype(d1) I;
+	V t = d - vtofloat(d1); // fractional distance through range
+	I r1 = visplat<I>(del->woffset) - d1; // relative to write index
+	V y0 = vgather<V>(buffer, r1 + visplat<I>(1), del->mask);
+	V y1 = vgather<V>(buffer, r1, del->mask);
+	V y2 = vgather<V>(buffer, r1 - visplat<I>(1), del->mask);
+	V y3 = vgather<V>(buffer, r1 - visplat<I>(2), del->mask);
+	V t2 = t * t, t3 = t2 * t; // cubic interpolation, as in dsp.h delread4()
+	V a0 = vsplat<V>(2.0f) * t2 - t3 - t;
+	V a1 = vsplat<V>(3.0f) * t3 - vsplat<V>(5.0f) * t2 + vsplat<V>(2.0f);
+	V a2 = vsplat<V>(4.0f) * t2 - vsplat<V>(3.0f) * t3 + t;
+	V a3 = t3 - t2;
+	return (a0 * y0 + a1 * y1 + a2 * y2 + a3 * y3) * vsplat<V>(0.5f);
+}
+
+static inline sample4 mdelread1_4(const MDELAY *del, const sample4 &ms) { return vmdelread1(del, ms); }
+static inline sample8 mdelread1_8(const MDELAY *del, const sample8 &ms) { return vmdelread1(del, ms); }
+static inline sample4 mdelread2_4(const MDELAY *del, const sample4 &ms) { return vmdelread2(del, ms); }
+static inline sample8 mdelread2_8(const MDELAY *del, const sample8 &ms) { return vmdelread2(del, ms); }
+static inline sample4 mdelread4_4(const MDELAY *del, const sample4 &ms) { return vmdelread4(del, ms); }
+static inline sample8 mdelread4_8(const MDELAY *del, const sample8 &ms) { return vmdelread4(del, ms); }
+
+//---------------------------------------------------------------------
+
+#if defined(__GNUC__) && ! defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+//---------------------------------------------------------------------
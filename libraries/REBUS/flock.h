@@ -0,0 +1,952 @@
+#pragma once
+
+/*
+
+	boids3d 2005 - 2006 a.sier / jasch 
+	adapted from boids by eric singer  1995-2003 eric l. singer
+	modified for use in non-Pd host in 2023 by Claude Heiland-Allen
+	rewritten as flock.h for large flocks in 2026
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+ 
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+ 
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+//---------------------------------------------------------------------
+// flocking (boids) for large flocks
+// 2026-10-16
+//
+// the flight model and Flock_* parameter API of the boids3d external
+// for Pure-data (see the copyright notice above),
+// reorganised so that it scales to thousands of boids:
+//
+// positions, directions and speeds are stored as separate arrays
+// (structure of arrays, padded to a multiple of 8 boids),
+// so the steering forces are accumulated 8 boids per vector step.
+//
+// nearest neighbours are found with a uniform grid rebuilt every step
+// (boids counting-sorted by cell), searching outwards from each boid's
+// cell only until the nearest neighbours are certain,
+// instead of measuring the distance between every pair of boids.
+// the cost per step is about linear in the number of boids
+// (quadratic for boids3d), less so when many boids bunch up
+// into a small space.
+//
+// boids are accessed as 'x->newPos.x[i]' instead of 'x->boid[i].newPos.x'.
+//
+// Flock_new(), Flock_numBoids() and Flock_free() allocate memory,
+// and Flock_resetBoids() uses rand() (as boids3d, so flocks start
+// in the same places): these are not realtime safe.
+// FlightStep() and the other parameter functions are.
+// a step can also be spread over several audio blocks,
+// see FlightStepStart().
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+#include "dsp_simd.h"
+
+// Maximum number of neighbours considered by each boid.
+#define FLOCK_MAX_NEIGHBORS 4
+
+// Work done by FlightStepContinue() per unit of its 'count':
+// the neighbours of one boid, or this many items (boids or grid cells)
+// of the cheaper passes that save the positions and sort the boids.
+#define FLOCK_STEP_ITEMS 32
+
+// Units of work in a step of 'n' boids, at most.
+#define FLOCK_STEP_WORK(n) ((n) + (10 * (n) + 38 + FLOCK_STEP_ITEMS - 1) / FLOCK_STEP_ITEMS)
+
+//---------------------------------------------------------------------
+// flock state
+
+// 3D vectors, one array per coordinate.
+typedef struct
+{
+	float *x, *y, *z;
+} FLOCK_VECTORS;
+
+typedef struct
+{
+	float x, y, z;
+} FLOCK_POINT;
+
+typedef struct
+{
+	float left, right;
+	float top, bottom;
+	float front, back;
+} FLOCK_BOX;
+
+typedef struct
+{
+	// parameters (see InitFlock() for defaults)
+	short mode;
+	long numBoids;
+	long numNeighbors;
+	FLOCK_BOX flyRect;
+	float minSpeed;
+	float maxSpeed;
+	float centerWeight;
+	float attractWeight;
+	float matchWeight;
+	float avoidWeight;
+	float wallsWeight;
+	float edgeDist;
+	float speedupFactor;
+	float inertiaFactor;
+	float accelFactor;
+	float prefDist;
+	float prefDistSqr;
+	FLOCK_POINT centerPt;
+	FLOCK_POINT attractPt;
+	// boids, 'capacity' elements per array (numBoids rounded up to 8)
+	long capacity;
+	FLOCK_VECTORS oldPos, newPos;
+	FLOCK_VECTORS oldDir, newDir;
+	float *speed;
+	// nearest neighbours, FLOCK_MAX_NEIGHBORS per boid
+	int *neighbor;
+	float *neighborDistSqr;
+	// steering due to neighbours, computed each step
+	FLOCK_VECTORS matchVel, avoidVel;
+	float *avoidSpeed;
+	// uniform grid, cube cells of side 'gridSize'
+	float gridLo[3];
+	float gridSize;
+	int gridDim[3];
+	int maxCells;
+	// cell of each boid
+	int *cell;
+	// boids sorted by cell, with those in cell 'c'
+	// from order[cellStart[c]] to order[cellStart[c + 1] - 1]
+	int *order;
+	int *cellStart;
+	// positions in the same order as 'order'
+	FLOCK_VECTORS sortedPos;
+	// progress of the current step: the pass ('stepPhase', see
+	// FLOCK_STEP_PHASE) and how far through it ('stepIndex'), then
+	// boids before 'stepNext' have their neighbours,
+	// boids before 'stepSteered' have moved
+	int stepPhase;
+	long stepIndex;
+	long stepNext;
+	long stepSteered;
+	// partial results of the passes
+	float centerSum[3];
+	float boundsLo[3], boundsHi[3];
+	int histogram[3][256];
+	long long gridCells;
+	// allocations holding the arrays above
+	float *floats;
+	int *ints;
+} FLOCK;
+
+// boids3d name
+typedef FLOCK t_boids;
+
+// Passes of a step, in order.
+enum FLOCK_STEP_PHASE
+{
+	// find the flock center and save the positions and directions
+	FLOCK_SAVE,
+	// find the extent of the flock, then its percentiles
+	FLOCK_BOUNDS,
+	FLOCK_HISTOGRAM,
+	// counting sort of the boids into grid cells
+	FLOCK_CLEAR,
+	FLOCK_COUNT,
+	FLOCK_PREFIX,
+	FLOCK_SCATTER,
+	// find the neighbours, and move the boids
+	FLOCK_NEIGHBORS
+};
+
+//---------------------------------------------------------------------
+// memory (not realtime safe)
+
+static inline void flock_deallocate(FLOCK *x)
+{
+	delete[] x->floats;
+	delete[] x->ints;
+	x->floats = nullptr;
+	x->ints = nullptr;
+	x->numBoids = 0;
+	x->capacity = 0;
+}
+
+// Allocate arrays for 'count' boids, returns false on failure.
+static inline bool flock_allocate(FLOCK *x, long count)
+{
+	flock_deallocate(x);
+	count = count > 0 ? count : 0;
+	long capacity = (count + 7) & ~7L;
+	// at most about 2 cells per boid
+	int maxCells = 2 * capacity + 1;
+	x->floats = new(std::nothrow) float[(23 + FLOCK_MAX_NEIGHBORS) * capacity]();
+	x->ints = new(std::nothrow) int[(FLOCK_MAX_NEIGHBORS + 2) * capacity + maxCells + 1]();
+	if (! x->floats || ! x->ints)
+	{
+		flock_deallocate(x);
+		return false;
+	}
+	float *f = x->floats;
+	FLOCK_VECTORS *v[] = { &x->oldPos, &x->newPos, &x->oldDir, &x->newDir, &x->matchVel, &x->avoidVel, &x->sortedPos };
+	for (auto p : v)
+	{
+		p->x = f; f += capacity;
+		p->y = f; f += capacity;
+		p->z = f; f += capacity;
+	}
+	x->speed = f; f += capacity;
+	x->avoidSpeed = f; f += capacity;
+	x->neighborDistSqr = f;
+	int *i = x->ints;
+	x->neighbor = i; i += FLOCK_MAX_NEIGHBORS * capacity;
+	x->cell = i; i += capacity;
+	x->order = i; i += capacity;
+	x->cellStart = i;
+	x->maxCells = maxCells;
+	x->numBoids = count;
+	x->capacity = capacity;
+	x->stepPhase = FLOCK_NEIGHBORS;
+	x->stepNext = count;
+	x->stepSteered = capacity;
+	return true;
+}
+
+//---------------------------------------------------------------------
+// parameters
+
+static inline void Flock_mode(FLOCK *x, float arg)
+{
+	long m = (long) arg;
+	x->mode = m < 0 ? 0 : m > 2 ? 2 : m;
+}
+
+static inline void Flock_numNeighbors(FLOCK *x, float arg)
+{
+	long n = (long) arg;
+	x->numNeighbors = n < 0 ? 0 : n > FLOCK_MAX_NEIGHBORS ? FLOCK_MAX_NEIGHBORS : n;
+}
+
+static inline void Flock_minSpeed(FLOCK *x, float arg)
+{
+	x->minSpeed = arg > 0.000001f ? arg : 0.000001f;
+}
+
+static inline void Flock_maxSpeed(FLOCK *x, float arg) { x->maxSpeed = arg; }
+static inline void Flock_centerWeight(FLOCK *x, float arg) { x->centerWeight = arg; }
+static inline void Flock_attractWeight(FLOCK *x, float arg) { x->attractWeight = arg; }
+static inline void Flock_matchWeight(FLOCK *x, float arg) { x->matchWeight = arg; }
+static inline void Flock_avoidWeight(FLOCK *x, float arg) { x->avoidWeight = arg; }
+static inline void Flock_wallsWeight(FLOCK *x, float arg) { x->wallsWeight = arg; }
+static inline void Flock_edgeDist(FLOCK *x, float arg) { x->edgeDist = arg; }
+static inline void Flock_speedupFactor(FLOCK *x, float arg) { x->speedupFactor = arg; }
+static inline void Flock_accelFactor(FLOCK *x, float arg) { x->accelFactor = arg; }
+
+static inline void Flock_inertiaFactor(FLOCK *x, float arg)
+{
+	x->inertiaFactor = arg == 0 ? 0.000001f : arg;
+}
+
+// (boids3d forgets to update prefDistSqr)
+static inline void Flock_prefDist(FLOCK *x, float arg)
+{
+	x->prefDist = arg;
+	x->prefDistSqr = arg * arg;
+}
+
+static inline void Flock_flyRect(FLOCK *x, float xlo, float ylo, float zlo, float xhi, float yhi, float zhi)
+{
+	x->flyRect.left = xlo;
+	x->flyRect.top = yhi;
+	x->flyRect.right = xhi;
+	x->flyRect.bottom = ylo;
+	x->flyRect.front = zhi;
+	x->flyRect.back = zlo;
+}
+
+static inline void Flock_attractPt(FLOCK *x, float ax, float ay, float az)
+{
+	x->attractPt.x = ax;
+	x->attractPt.y = ay;
+	x->attractPt.z = az;
+}
+
+//---------------------------------------------------------------------
+// initialization
+
+// Random number between the bounds, as boids3d.
+static inline float flock_random(float minRange, float maxRange)
+{
+	unsigned short qdRdm = rand();
+	float t = qdRdm / 65536.0f;
+	return t * (maxRange - minRange) + minRange;
+}
+
+// Scatter the boids randomly within the flyRect.
+static inline void Flock_resetBoids(FLOCK *x)
+{
+	size_t bytes = sizeof(float) * x->capacity;
+	for (int k = 0; k < 23 + FLOCK_MAX_NEIGHBORS; ++k)
+	{
+		memset(x->floats + k * x->capacity, 0, bytes);
+	}
+	memset(x->neighbor, 0, sizeof(int) * FLOCK_MAX_NEIGHBORS * x->capacity);
+	// (abandon any step in progress)
+	x->stepPhase = FLOCK_NEIGHBORS;
+	x->stepNext = x->numBoids;
+	x->stepSteered = x->capacity;
+	for (long i = 0; i < x->numBoids; ++i)
+	{
+		x->newPos.x[i] = x->oldPos.x[i] = flock_random(x->flyRect.right, x->flyRect.left);
+		x->newPos.y[i] = x->oldPos.y[i] = flock_random(x->flyRect.bottom, x->flyRect.top);
+		x->newPos.z[i] = x->oldPos.z[i] = flock_random(x->flyRect.back, x->flyRect.front);
+		float rndAngle = flock_random(0, 360) * float(M_PI / 180);
+		x->newDir.x[i] = sinf(rndAngle);
+		x->newDir.y[i] = cosf(rndAngle);
+		x->newDir.z[i] = (cosf(rndAngle) + sinf(rndAngle)) * 0.5f;
+		x->speed[i] = (0.25f + 0.15f) * 0.5f;
+	}
+}
+
+// Reset the parameters to their defaults and scatter the boids.
+static inline void InitFlock(FLOCK *x)
+{
+	x->numNeighbors = 2;
+	x->minSpeed = 0.15f;
+	x->maxSpeed = 0.25f;
+	x->centerWeight = 0.25f; // flock centering
+	x->attractWeight = 0.3f; // attraction point seeking
+	x->matchWeight = 0.1f; // neighbors velocity matching
+	x->avoidWeight = 0.1f; // neighbors avoidance
+	x->wallsWeight = 0.5f; // wall avoidance
+	x->edgeDist = 0.5f; // vision distance to avoid wall edges
+	x->speedupFactor = 0.1f; // alter animation speed
+	x->inertiaFactor = 0.2f; // willingness to change speed & direction
+	x->accelFactor = 0.1f; // neighbor avoidance accelerate or decelerate rate
+	x->prefDist = 0.25f; // preferred distance from neighbors
+	x->prefDistSqr = x->prefDist * x->prefDist;
+	Flock_flyRect(x, -1, -1, -1, 1, 1, 1);
+	Flock_attractPt(x, 0, 0, 0);
+	Flock_resetBoids(x);
+}
+
+static inline void Flock_reset(FLOCK *x)
+{
+	InitFlock(x);
+}
+
+// Allocate a flock of 'count' boids, returns nullptr on failure.
+static inline FLOCK *Flock_new(int count)
+{
+	FLOCK *x = new(std::nothrow) FLOCK();
+	if (! x)
+	{
+		return nullptr;
+	}
+	if (! flock_allocate(x, count))
+	{
+		delete x;
+		return nullptr;
+	}
+	InitFlock(x);
+	x->mode = 0;
+	return x;
+}
+
+// Change the number of boids and scatter them.
+static inline void Flock_numBoids(FLOCK *x, float arg)
+{
+	flock_allocate(x, (long) arg);
+	Flock_resetBoids(x);
+}
+
+static inline void Flock_free(FLOCK *x)
+{
+	if (x)
+	{
+		flock_deallocate(x);
+		delete x;
+	}
+}
+
+//---------------------------------------------------------------------
+// flight (realtime safe)
+
+static inline FLOCK_POINT FindFlockCenter(const FLOCK *x)
+{
+	float totalH = 0, totalV = 0, totalD = 0;
+	for (long i = 0; i < x->numBoids; ++i)
+	{
+		totalH += x->oldPos.x[i];
+		totalV += x->oldPos.y[i];
+		totalD += x->oldPos.z[i];
+	}
+	FLOCK_POINT centerPoint = { totalH / x->numBoids, totalV / x->numBoids, totalD / x->numBoids };
+	return centerPoint;
+}
+
+// Grid cell coordinate of 'p' along 'axis'.
+static inline int flock_cell(const FLOCK *x, int axis, float p)
+{
+	float c = (p - x->gridLo[axis]) / x->gridSize;
+	int i = c >= 0 ? int(c) : 0; // also for NaN
+	return i < x->gridDim[axis] ? i : x->gridDim[axis] - 1;
+}
+
+// Bin of 'p' in the histogram along 'axis'.
+static inline int flock_bin(const FLOCK *x, int axis, float p)
+{
+	const int bins = 256;
+	float lo = x->boundsLo[axis], hi = x->boundsHi[axis];
+	float scale = hi > lo ? bins / (hi - lo) : 0.0f;
+	float b = (p - lo) * scale;
+	int j = b >= 0 ? int(b) : 0; // also for NaN
+	return j < bins ? j : bins - 1;
+}
+
+// Size the grid from the histograms.
+// flocks are often a dense core with stragglers, so the grid covers
+// the middle 90% of the boids along each axis, sized for about one boid
+// per cell there, and boids outside are put in the nearest edge cell.
+static inline void flock_gridSize(FLOCK *x)
+{
+	long n = x->numBoids;
+	float extent[3], largest = 0;
+	for (int a = 0; a < 3; ++a)
+	{
+		// 5th and 95th percentiles
+		const int bins = 256;
+		const int *count = x->histogram[a];
+		float lo = x->boundsLo[a], hi = x->boundsHi[a];
+		float scale = hi > lo ? bins / (hi - lo) : 0.0f;
+		long tail = n / 20, below = 0;
+		int first = 0, last = bins - 1;
+		while (first < last && below + count[first] <= tail)
+		{
+			below += count[first++];
+		}
+		below = 0;
+		while (last > first && below + count[last] <= tail)
+		{
+			below += count[last--];
+		}
+		if (scale > 0)
+		{
+			hi = lo + (last + 1) / scale;
+			lo = lo + first / scale;
+		}
+		x->gridLo[a] = lo;
+		extent[a] = fmaxf(hi - lo, 1.0e-6f);
+		largest = fmaxf(largest, extent[a]);
+	}
+	float size = fmaxf(cbrtf(extent[0] * extent[1] * extent[2] / n), largest / 1024);
+	long long cells;
+	do
+	{
+		cells = 1;
+		for (int a = 0; a < 3; ++a)
+		{
+			x->gridDim[a] = int(extent[a] / size) + 1;
+			cells *= x->gridDim[a];
+		}
+		size *= 1.25f;
+	}
+	while (cells > x->maxCells);
+	x->gridSize = size / 1.25f;
+	x->gridCells = cells;
+}
+
+// Do up to 'items' of the current pass before the neighbour search,
+// returns the number of items left over.
+static inline long flock_pass(FLOCK *x, long items)
+{
+	const long n = x->numBoids;
+	const long i = x->stepIndex;
+	const float *p[3] = { x->oldPos.x, x->oldPos.y, x->oldPos.z };
+	int *start = x->cellStart;
+	long total = 0;
+	switch (x->stepPhase)
+	{
+		case FLOCK_SAVE: total = x->capacity; break;
+		case FLOCK_CLEAR: total = x->gridCells + 1; break;
+		case FLOCK_PREFIX: total = x->gridCells; break;
+		default: total = n; break;
+	}
+	const long end = i + items < total ? i + items : total;
+	switch (x->stepPhase)
+	{
+		case FLOCK_SAVE:
+		{
+			// (as boids3d, the center lags: it uses the positions saved by the previous step)
+			for (long k = i; k < end && k < n; ++k)
+			{
+				x->centerSum[0] += x->oldPos.x[k];
+				x->centerSum[1] += x->oldPos.y[k];
+				x->centerSum[2] += x->oldPos.z[k];
+			}
+			size_t bytes = sizeof(float) * (end - i);
+			FLOCK_VECTORS *from[] = { &x->newPos, &x->newDir };
+			FLOCK_VECTORS *to[] = { &x->oldPos, &x->oldDir };
+			for (int v = 0; v < 2; ++v)
+			{
+				memcpy(to[v]->x + i, from[v]->x + i, bytes);
+				memcpy(to[v]->y + i, from[v]->y + i, bytes);
+				memcpy(to[v]->z + i, from[v]->z + i, bytes);
+			}
+			if (x->numNeighbors <= 0)
+			{
+				// (padding lanes are kept zero, so clear everything)
+				FLOCK_VECTORS *vel[] = { &x->matchVel, &x->avoidVel };
+				for (int v = 0; v < 2; ++v)
+				{
+					memset(vel[v]->x + i, 0, bytes);
+					memset(vel[v]->y + i, 0, bytes);
+					memset(vel[v]->z + i, 0, bytes);
+				}
+				memset(x->avoidSpeed + i, 0, bytes);
+			}
+			break;
+		}
+		case FLOCK_BOUNDS:
+			for (int a = 0; a < 3; ++a)
+			{
+				float lo = x->boundsLo[a], hi = x->boundsHi[a];
+				for (long k = i; k < end; ++k)
+				{
+					lo = fminf(lo, p[a][k]);
+					hi = fmaxf(hi, p[a][k]);
+				}
+				x->boundsLo[a] = lo;
+				x->boundsHi[a] = hi;
+			}
+			break;
+		case FLOCK_HISTOGRAM:
+			for (int a = 0; a < 3; ++a)
+			{
+				for (long k = i; k < end; ++k)
+				{
+					x->histogram[a][flock_bin(x, a, p[a][k])]++;
+				}
+			}
+			break;
+		case FLOCK_CLEAR:
+			memset(start + i, 0, sizeof(int) * (end - i));
+			break;
+		case FLOCK_COUNT:
+			for (long k = i; k < end; ++k)
+			{
+				int c
+					= (flock_cell(x, 2, p[2][k]) * x->gridDim[1]
+					+ flock_cell(x, 1, p[1][k])) * x->gridDim[0]
+					+ flock_cell(x, 0, p[0][k]);
+				x->cell[k] = c;
+				start[c]++;
+			}
+			break;
+		case FLOCK_PREFIX:
+			// afterwards start[c] is the end of cell 'c'
+			for (long c = i > 0 ? i : 1; c < end; ++c)
+			{
+				start[c] += start[c - 1];
+			}
+			break;
+		case FLOCK_SCATTER:
+			// backwards from the end of each cell, so boids stay in order
+			// and afterwards start[c] is the start of cell 'c'
+			for (long m = i; m < end; ++m)
+			{
+				long k = n - 1 - m;
+				int j = --start[x->cell[k]];
+				x->order[j] = k;
+				x->sortedPos.x[j] = p[0][k];
+				x->sortedPos.y[j] = p[1][k];
+				x->sortedPos.z[j] = p[2][k];
+			}
+			break;
+	}
+	x->stepIndex = end;
+	if (end == total)
+	{
+		// next pass
+		x->stepIndex = 0;
+		switch (x->stepPhase)
+		{
+			case FLOCK_SAVE:
+				x->centerPt.x = x->centerSum[0] / n;
+				x->centerPt.y = x->centerSum[1] / n;
+				x->centerPt.z = x->centerSum[2] / n;
+				if (x->numNeighbors > 0)
+				{
+					x->stepPhase = FLOCK_BOUNDS;
+					for (int a = 0; a < 3; ++a)
+					{
+						x->boundsLo[a] = x->boundsHi[a] = p[a][0];
+					}
+				}
+				else
+				{
+					x->stepPhase = FLOCK_NEIGHBORS;
+				}
+				break;
+			case FLOCK_BOUNDS:
+				x->stepPhase = FLOCK_HISTOGRAM;
+				memset(x->histogram, 0, sizeof(x->histogram));
+				break;
+			case FLOCK_HISTOGRAM:
+				x->stepPhase = FLOCK_CLEAR;
+				flock_gridSize(x);
+				break;
+			case FLOCK_SCATTER:
+				x->stepPhase = FLOCK_NEIGHBORS;
+				start[x->gridCells] = n;
+				break;
+			default:
+				x->stepPhase++;
+				break;
+		}
+	}
+	return items - (end - i);
+}
+
+// Is the neighbor (at 'q') in front of the boid (at 'p' moving in direction 'd')?
+// As boids3d: tested in the xy and yz planes.
+static inline bool flock_inFront(float px, float py, float pz, float dx, float dy, float dz, float qx, float qy, float qz)
+{
+	// xy plane
+	if (dx != 0)
+	{
+		// line perpendicular to the direction through the boid
+		float grad = -dy / dx;
+		float intercept = py - grad * px;
+		if (qx >= (qy - intercept) / grad ? ! (dx > 0) : ! (dx < 0))
+		{
+			return false;
+		}
+	}
+	else if (dy > 0 ? ! (qy > py) : ! (qy < py))
+	{
+		return false;
+	}
+	// yz plane
+	if (dy != 0)
+	{
+		float grad = -dz / dy;
+		float intercept = pz - grad * py;
+		if (qy >= (qz - intercept) / grad ? ! (dy > 0) : ! (dy < 0))
+		{
+			return false;
+		}
+	}
+	else if (dz > 0 ? ! (qz > pz) : ! (qz < pz))
+	{
+		return false;
+	}
+	return true;
+}
+
+// Find the nearest neighbours of boid 'b' and the steering they cause.
+static inline void flock_neighbors(FLOCK *x, long b)
+{
+	const int k = x->numNeighbors;
+	int *neighbor = x->neighbor + b * FLOCK_MAX_NEIGHBORS;
+	float *distSqr = x->neighborDistSqr + b * FLOCK_MAX_NEIGHBORS;
+	const float px = x->oldPos.x[b], py = x->oldPos.y[b], pz = x->oldPos.z[b];
+	for (int j = 0; j < k; ++j)
+	{
+		distSqr[j] = 4294967295.0f;
+	}
+	// search shells of cells at increasing distance from the boid's cell
+	// (Chebyshev distance 'r' cells), until the k-th nearest so far
+	// is nearer than anything outside the searched cube can be
+	const float q[3] = { px, py, pz };
+	const int c[3] = { flock_cell(x, 0, px), flock_cell(x, 1, py), flock_cell(x, 2, pz) };
+	const int *dim = x->gridDim;
+	int rmax = dim[0] > dim[1] ? dim[0] : dim[1];
+	rmax = rmax > dim[2] ? rmax : dim[2];
+	for (int r = 0; r < rmax; ++r)
+	{
+		for (int dz = -r; dz <= r; ++dz)
+		{
+			int cz = c[2] + dz;
+			if (cz < 0 || cz >= dim[2])
+			{
+				continue;
+			}
+			for (int dy = -r; dy <= r; ++dy)
+			{
+				int cy = c[1] + dy;
+				if (cy < 0 || cy >= dim[1])
+				{
+					continue;
+				}
+				// inside the shell, only the two end cells in x
+				int step = r == 0 || dz == -r || dz == r || dy == -r || dy == r ? 1 : 2 * r;
+				for (int dx = -r; dx <= r; dx += step)
+				{
+					int cx = c[0] + dx;
+					if (cx < 0 || cx >= dim[0])
+					{
+						continue;
+					}
+					int cell = (cz * dim[1] + cy) * dim[0] + cx;
+					for (int s = x->cellStart[cell]; s < x->cellStart[cell + 1]; ++s)
+					{
+						float h = x->sortedPos.x[s] - px;
+						float v = x->sortedPos.y[s] - py;
+						float d = x->sortedPos.z[s] - pz;
+						float dist = h * h + v * v + d * d;
+						// sort into the array, smallest first
+						int i = x->order[s];
+						if (dist < distSqr[k - 1] && i != b)
+						{
+							int j = k - 1;
+							while (j > 0 && dist < distSqr[j - 1])
+							{
+								distSqr[j] = distSqr[j - 1];
+								neighbor[j] = neighbor[j - 1];
+								--j;
+							}
+							distSqr[j] = dist;
+							neighbor[j] = i;
+						}
+					}
+				}
+			}
+		}
+		// distance to the nearest face of the searched cube
+		// (faces on the edge of the grid have nothing beyond)
+		float reach = 4294967295.0f;
+		for (int a = 0; a < 3; ++a)
+		{
+			if (c[a] - r > 0)
+			{
+				reach = fminf(reach, q[a] - (x->gridLo[a] + (c[a] - r) * x->gridSize));
+			}
+			if (c[a] + r + 1 < dim[a])
+			{
+				reach = fminf(reach, x->gridLo[a] + (c[a] + r + 1) * x->gridSize - q[a]);
+			}
+		}
+		if (distSqr[k - 1] <= reach * reach)
+		{
+			break;
+		}
+	}
+	// match and avoid the neighbours
+	const float dx = x->oldDir.x[b], dy = x->oldDir.y[b], dz = x->oldDir.z[b];
+	const float accel = x->accelFactor / 100.0f;
+	float matchX = 0, matchY = 0, matchZ = 0;
+	float totalX = 0, totalY = 0, totalZ = 0;
+	float tempSpeed = x->speed[b];
+	int numClose = 0;
+	for (int j = 0; j < k; ++j)
+	{
+		int i = neighbor[j];
+		// average the neighbor velocities
+		matchX += x->oldDir.x[i];
+		matchY += x->oldDir.y[i];
+		matchZ += x->oldDir.z[i];
+		// if distance is less than preferred distance, then neighbor influences boid
+		bool close = distSqr[j] < x->prefDistSqr;
+		if (close)
+		{
+			float dist = sqrtf(distSqr[j]);
+			float distH = x->oldPos.x[i] - px;
+			float distV = x->oldPos.y[i] - py;
+			float distD = x->oldPos.z[i] - pz;
+			if (dist == 0)
+			{
+				dist = 0.0000001f;
+			}
+			float f = x->prefDist / dist;
+			totalX = totalX - distH - distH * f;
+			totalY = totalY - distV - distV * f;
+			totalZ = totalZ - distD - distV * f; // (sic, as boids3d)
+			numClose++;
+		}
+		// adjust speed
+		if (flock_inFront(px, py, pz, dx, dy, dz, x->oldPos.x[i], x->oldPos.y[i], x->oldPos.z[i]) == close)
+		{
+			tempSpeed /= accel;
+		}
+		else
+		{
+			tempSpeed *= accel;
+		}
+	}
+	if (numClose)
+	{
+		x->avoidVel.x[b] = totalX / numClose;
+		x->avoidVel.y[b] = totalY / numClose;
+		x->avoidVel.z[b] = totalZ / numClose;
+		float h = sqrtf(matchX * matchX + matchY * matchY + matchZ * matchZ);
+		if (h != 0)
+		{
+			matchX /= h;
+			matchY /= h;
+			matchZ /= h;
+		}
+	}
+	else
+	{
+		x->avoidVel.x[b] = 0;
+		x->avoidVel.y[b] = 0;
+		x->avoidVel.z[b] = 0;
+	}
+	x->matchVel.x[b] = matchX;
+	x->matchVel.y[b] = matchY;
+	x->matchVel.z[b] = matchZ;
+	x->avoidSpeed[b] = tempSpeed;
+}
+
+// sample8 is returned by value without AVX, which GCC warns about
+#if defined(__GNUC__) && ! defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+// Scale to unit length (if not zero).
+static inline void flock_normalize(sample8 &x, sample8 &y, sample8 &z)
+{
+	sample8 h2 = x * x + y * y + z * z;
+	sample8 g = vselect(splat8(0.0f), h2, rsqrt8(h2), splat8(1.0f));
+	x = x * g;
+	y = y * g;
+	z = z * g;
+}
+
+// Combine the steering forces and move boids 'from' to 'to' (multiples of 8).
+static inline void flock_steer(FLOCK *x, long from, long to)
+{
+	const sample8 zero = splat8(0.0f);
+	const sample8 inertia = splat8(x->inertiaFactor);
+	const sample8 invInertia = splat8(1.0f / x->inertiaFactor);
+	const sample8 centerWeight = splat8(x->centerWeight);
+	const sample8 attractWeight = splat8(x->attractWeight);
+	const sample8 matchWeight = splat8(x->matchWeight);
+	const sample8 avoidWeight = splat8(x->avoidWeight);
+	const sample8 wallsWeight = splat8(x->wallsWeight);
+	const sample8 edgeDist = splat8(x->edgeDist);
+	const sample8 minSpeed = splat8(x->minSpeed);
+	const sample8 maxSpeed = splat8(x->maxSpeed);
+	const sample8 speedup = splat8(x->speedupFactor / 100.0f);
+	for (long i = from; i < to; i += 8)
+	{
+		sample8 px = load8(x->oldPos.x + i), py = load8(x->oldPos.y + i), pz = load8(x->oldPos.z + i);
+		sample8 dx = load8(x->oldDir.x + i), dy = load8(x->oldDir.y + i), dz = load8(x->oldDir.z + i);
+		sample8 speed = load8(x->speed + i);
+		// seek the flock center and the attraction point
+		sample8 cx = splat8(x->centerPt.x) - px, cy = splat8(x->centerPt.y) - py, cz = splat8(x->centerPt.z) - pz;
+		flock_normalize(cx, cy, cz);
+		sample8 ax = splat8(x->attractPt.x) - px, ay = splat8(x->attractPt.y) - py, az = splat8(x->attractPt.z) - pz;
+		flock_normalize(ax, ay, az);
+		// avoid walls, testing a point in front of the nose of the boid
+		// (distance depends on the boid's speed and the avoid edge constant)
+		sample8 reach = speed * edgeDist;
+		sample8 tx = px + dx * reach, ty = py + dy * reach, tz = pz + dz * reach;
+		sample8 wx = vabs(dx), wy = vabs(dy), wz = vabs(dz);
+		wx = vselect(tx, splat8(x->flyRect.left), wx, vselect(splat8(x->flyRect.right), tx, zero - wx, zero));
+		wy = vselect(ty, splat8(x->flyRect.top), wy, vselect(splat8(x->flyRect.bottom), ty, zero - wy, zero));
+		wz = vselect(tz, splat8(x->flyRect.front), wz, vselect(splat8(x->flyRect.back), tz, zero - wz, zero));
+		// compute resultant velocity using weights and inertia
+		sample8 mx = load8(x->matchVel.x + i), my = load8(x->matchVel.y + i), mz = load8(x->matchVel.z + i);
+		sample8 vx = load8(x->avoidVel.x + i), vy = load8(x->avoidVel.y + i), vz = load8(x->avoidVel.z + i);
+		sample8 nx = inertia * dx + (centerWeight * cx + attractWeight * ax + matchWeight * mx + avoidWeight * vx + wallsWeight * wx) * invInertia;
+		sample8 ny = inertia * dy + (centerWeight * cy + attractWeight * ay + matchWeight * my + avoidWeight * vy + wallsWeight * wy) * invInertia;
+		sample8 nz = inertia * dz + (centerWeight * cz + attractWeight * az + matchWeight * mz + avoidWeight * vz + wallsWeight * wz) * invInertia;
+		flock_normalize(nx, ny, nz);
+		// speed from neighbours, bounded by minSpeed and maxSpeed
+		sample8 s = load8(x->avoidSpeed + i);
+		s = vselect(s, minSpeed, minSpeed, vselect(maxSpeed, s, maxSpeed, s));
+		// new position, applying speedupFactor
+		sample8 step = s * speedup;
+		store8(x->newDir.x + i, nx);
+		store8(x->newDir.y + i, ny);
+		store8(x->newDir.z + i, nz);
+		store8(x->speed + i, s);
+		store8(x->newPos.x + i, px + nx * step);
+		store8(x->newPos.y + i, py + ny * step);
+		store8(x->newPos.z + i, pz + nz * step);
+	}
+}
+
+#if defined(__GNUC__) && ! defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+// Start a step of the flock.  The step is done by FlightStepContinue(),
+// which can be called with a little work at a time to spread the cost
+// of a step evenly over several audio blocks (FLOCK_STEP_WORK(numBoids)
+// units in total): first the positions are saved, the flock center found
+// and the boids sorted into the grid, then each boid's neighbours found
+// and the boids moved.
+// Parameters should not be changed until the step is complete.
+static inline void FlightStepStart(FLOCK *x)
+{
+	x->stepPhase = x->numBoids > 0 ? FLOCK_SAVE : FLOCK_NEIGHBORS;
+	x->stepIndex = 0;
+	x->stepNext = 0;
+	x->stepSteered = 0;
+	x->centerSum[0] = x->centerSum[1] = x->centerSum[2] = 0;
+}
+
+// Continue the step started by FlightStepStart() by up to 'count' units
+// of work (see FLOCK_STEP_ITEMS).
+// Returns true when the step is complete: until then
+// newPos, newDir and speed are partly updated.
+static inline bool FlightStepContinue(FLOCK *x, long count)
+{
+	if (x->stepPhase < FLOCK_NEIGHBORS)
+	{
+		long items = count * FLOCK_STEP_ITEMS;
+		while (x->stepPhase < FLOCK_NEIGHBORS && items > 0)
+		{
+			items = flock_pass(x, items);
+		}
+		count = items / FLOCK_STEP_ITEMS;
+	}
+	long end = x->stepNext + count < x->numBoids ? x->stepNext + count : x->numBoids;
+	if (x->stepPhase < FLOCK_NEIGHBORS)
+	{
+		return false;
+	}
+	if (x->numNeighbors > 0)
+	{
+		for (long i = x->stepNext; i < end; ++i)
+		{
+			flock_neighbors(x, i);
+		}
+	}
+	x->stepNext = end;
+	// move the boids in groups of 8 once they all have their neighbours
+	long steer = end == x->numBoids ? x->capacity : end & ~7L;
+	if (steer > x->stepSteered)
+	{
+		flock_steer(x, x->stepSteered, steer);
+		x->stepSteered = steer;
+	}
+	return end == x->numBoids;
+}
+
+// Move the flock one step.
+static inline void FlightStep(FLOCK *x)
+{
+	FlightStepStart(x);
+	FlightStepContinue(x, FLOCK_STEP_WORK(x->numBoids));
+}
+
+//---------------------------------------------------------------------
@@ -0,0 +1,468 @@
+#pragma once
+
+//---------------------------------------------------------------------
+// nearest-neighbour search for gestures
+// 2026-10-16
+//
+// a gesture is a window of 'length' frames of 'channels' control
+// signals, and the distance between two gestures is the squared
+// difference summed over frames and channels, weighted per frame
+// by a window function.
+//
+// the index holds every gesture starting at a multiple of 'stride'
+// frames in a recording of control data.  it is built in two parts:
+// - the weighted gestures are projected onto their first
+//   GESTURE_DIMENSIONS principal components (found from the
+//   covariance by power iteration)
+// - a k-d tree is built on the projections
+// because the projection is orthonormal, distances between projections
+// are never more than the true distances, so the tree can be searched
+// exactly, computing true distances only for gestures that could be
+// nearer than those found so far.  searches can also be approximate:
+// the nearest by projection are found, then reranked by true distance.
+//
+// for smooth (low-pass filtered) control signals, most of the variation
+// is in the first few components, and a search visits a small fraction
+// of the gestures.
+//
+// the recording must stay unchanged while the index is in use.
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <new>
+
+// Number of principal components, '#define GESTURE_DIMENSIONS 4'
+// before including for faster but less selective searches.
+#ifndef GESTURE_DIMENSIONS
+#define GESTURE_DIMENSIONS 8
+#endif
+
+// Gestures per leaf of the k-d tree.
+#define GESTURE_LEAF 8
+
+// Maximum candidates for approximate searches.
+#define GESTURE_RERANK_MAX 64
+
+//---------------------------------------------------------------------
+// index state
+
+typedef struct
+{
+	// recording, 'frames' frames of 'channels' interleaved samples
+	const float *data;
+	// per-frame weights, 'length' values
+	const float *weight;
+	int length;
+	int channels;
+	int stride;
+	// number of gestures indexed, at most 'capacity'
+	int count;
+	int capacity;
+	// mean, square roots of weights, and principal components
+	// (GESTURE_DIMENSIONS rows of length * channels values,
+	// and a row of scratch space for building)
+	float *mean;
+	float *root;
+	float *basis;
+	// projections, GESTURE_DIMENSIONS per gesture
+	float *point;
+	// gestures in k-d tree order (gesture 'i' starts at frame i * stride)
+	int *order;
+	// k-d tree, implicit: node 'k' covering order[lo..hi) has children
+	// 2k+1 covering order[lo..mid) and 2k+2 covering order[mid..hi),
+	// with mid = (lo + hi) / 2, split at 'split[k]' along 'axis[k]'
+	float *split;
+	unsigned char *axis;
+	int nodes;
+	// covariance, for building
+	double *covariance;
+} GESTURE_INDEX;
+
+//---------------------------------------------------------------------
+// setup and cleanup (not realtime safe: allocates memory)
+
+// Free the index memory.
+static inline void gesture_index_cleanup(GESTURE_INDEX *x)
+{
+	delete[] x->mean;
+	delete[] x->root;
+	delete[] x->basis;
+	delete[] x->point;
+	delete[] x->order;
+	delete[] x->split;
+	delete[] x->axis;
+	delete[] x->covariance;
+	memset(x, 0, sizeof(*x));
+}
+
+// Allocate an index for up to 'capacity' gestures.
+// Returns false if memory could not be allocated.
+static inline bool gesture_index_setup(GESTURE_INDEX *x, int capacity, int length, int channels)
+{
+	memset(x, 0, sizeof(*x));
+	int m = length * channels;
+	int nodes = 8 * (capacity / GESTURE_LEAF + 1);
+	x->mean = new(std::nothrow) float[m];
+	x->root = new(std::nothrow) float[length];
+	x->basis = new(std::nothrow) float[(GESTURE_DIMENSIONS + 1) * m];
+	x->point = new(std::nothrow) float[size_t(capacity) * GESTURE_DIMENSIONS];
+	x->order = new(std::nothrow) int[capacity];
+	x->split = new(std::nothrow) float[nodes];
+	x->axis = new(std::nothrow) unsigned char[nodes];
+	x->covariance = new(std::nothrow) double[size_t(m) * m];
+	if (! x->mean || ! x->root || ! x->basis || ! x->point || ! x->order || ! x->split || ! x->axis || ! x->covariance)
+	{
+		gesture_index_cleanup(x);
+		return false;
+	}
+	x->length = length;
+	x->channels = channels;
+	x->capacity = capacity;
+	x->nodes = nodes;
+	return true;
+}
+
+//---------------------------------------------------------------------
+// building (not realtime safe: takes time proportional to the count,
+// so run it in an auxiliary task; does not allocate memory)
+
+// Build the k-d tree for order[lo..hi) at node 'k'.
+static inline void gesture_index_tree(GESTURE_INDEX *x, int k, int lo, int hi)
+{
+	if (hi - lo <= GESTURE_LEAF)
+	{
+		return;
+	}
+	// split along the axis with the widest spread
+	float spread = -1;
+	int a = 0;
+	for (int d = 0; d < GESTURE_DIMENSIONS; ++d)
+	{
+		float vmin = x->point[x->order[lo] * GESTURE_DIMENSIONS + d], vmax = vmin;
+		for (int i = lo + 1; i < hi; ++i)
+		{
+			float v = x->point[x->order[i] * GESTURE_DIMENSIONS + d];
+			vmin = v < vmin ? v : vmin;
+			vmax = v > vmax ? v : vmax;
+		}
+		if (vmax - vmin > spread)
+		{
+			spread = vmax - vmin;
+			a = d;
+		}
+	}
+	int mid = (lo + hi) / 2;
+	const float *point = x->point;
+	std::nth_element(x->order + lo, x->order + mid, x->order + hi,
+		[point, a](int i, int j) { return point[i * GESTURE_DIMENSIONS + a] < point[j * GESTURE_DIMENSIONS + a]; });
+	x->axis[k] = a;
+	x->split[k] = point[x->order[mid] * GESTURE_DIMENSIONS + a];
+	gesture_index_tree(x, 2 * k + 1, lo, mid);
+	gesture_index_tree(x, 2 * k + 2, mid, hi);
+}
+
+// Index the 'count' gestures starting every 'stride' frames in 'data'
+// (which must have at least (count - 1) * stride + length frames),
+// weighted by 'weight' (which must not be negative).
+static inline void gesture_index_build(GESTURE_INDEX *x, const float *data, const float *weight, int count, int stride)
+{
+	const int length = x->length, channels = x->channels, m = length * channels;
+	count = count < x->capacity ? count : x->capacity;
+	x->data = data;
+	x->weight = weight;
+	x->stride = stride;
+	x->count = 0;
+	if (count <= 0)
+	{
+		return;
+	}
+	for (int i = 0; i < length; ++i)
+	{
+		x->root[i] = sqrtf(weight[i]);
+	}
+	// mean and covariance of the weighted gestures (a sample of them)
+	int step = count / 4096 + 1, samples = 0;
+	memset(x->mean, 0, sizeof(float) * m);
+	memset(x->covariance, 0, sizeof(double) * m * m);
+	for (int g = 0; g < count; g += step, ++samples)
+	{
+		const float *p = data + size_t(g) * stride * channels;
+		for (int i = 0; i < m; ++i)
+		{
+			x->mean[i] += x->root[i / channels] * p[i];
+		}
+	}
+	for (int i = 0; i < m; ++i)
+	{
+		x->mean[i] /= samples;
+	}
+	for (int g = 0; g < count; g += step)
+	{
+		const float *p = data + size_t(g) * stride * channels;
+		for (int i = 0; i < m; ++i)
+		{
+			double u = x->root[i / channels] * p[i] - x->mean[i];
+			for (int j = 0; j <= i; ++j)
+			{
+				x->covariance[i * m + j] += u * (x->root[j / channels] * p[j] - x->mean[j]);
+			}
+		}
+	}
+	for (int i = 0; i < m; ++i)
+	{
+		for (int j = 0; j < i; ++j)
+		{
+			x->covariance[j * m + i] = x->covariance[i * m + j];
+		}
+	}
+	// principal components by power iteration,
+	// each kept orthogonal to the ones before
+	// (rows are left zero if the data has fewer dimensions)
+	for (int d = 0; d < GESTURE_DIMENSIONS; ++d)
+	{
+		float *v = x->basis + d * m;
+		for (int i = 0; i < m; ++i)
+		{
+			v[i] = cosf(i * (d + 1) + 1.0f);
+		}
+		for (int iteration = 0; iteration < 64; ++iteration)
+		{
+			// orthogonalize and normalize
+			for (int e = 0; e < d; ++e)
+			{
+				const float *u = x->basis + e * m;
+				double dot = 0;
+				for (int i = 0; i < m; ++i)
+				{
+					dot += u[i] * v[i];
+				}
+				for (int i = 0; i < m; ++i)
+				{
+					v[i] -= dot * u[i];
+				}
+			}
+			double norm = 0;
+			for (int i = 0; i < m; ++i)
+			{
+				norm += v[i] * v[i];
+			}
+			if (! (norm > 1.0e-20))
+			{
+				memset(v, 0, sizeof(float) * m);
+				break;
+			}
+			norm = 1 / sqrt(norm);
+			for (int i = 0; i < m; ++i)
+			{
+				v[i] *= norm;
+			}
+			if (iteration == 63)
+			{
+				break;
+			}
+			// multiply by the covariance
+			float *w = x->basis + GESTURE_DIMENSIONS * m;
+			for (int i = 0; i < m; ++i)
+			{
+				double s = 0;
+				for (int j = 0; j < m; ++j)
+				{
+					s += x->covariance[i * m + j] * v[j];
+				}
+				w[i] = s;
+			}
+			memcpy(v, w, sizeof(float) * m);
+		}
+	}
+	// project every gesture
+	for (int g = 0; g < count; ++g)
+	{
+		const float *p = data + size_t(g) * stride * channels;
+		for (int d = 0; d < GESTURE_DIMENSIONS; ++d)
+		{
+			const float *v = x->basis + d * m;
+			float s = 0;
+			for (int i = 0; i < m; ++i)
+			{
+				s += v[i] * (x->root[i / channels] * p[i] - x->mean[i]);
+			}
+			// (keep the tree ordering well-defined)
+			x->point[g * GESTURE_DIMENSIONS + d] = fabsf(s) <= 3.0e38f ? s : 0.0f;
+		}
+		x->order[g] = g;
+	}
+	gesture_index_tree(x, 0, 0, count);
+	x->count = count;
+}
+
+//---------------------------------------------------------------------
+// searching (realtime safe)
+
+typedef struct
+{
+	const GESTURE_INDEX *index;
+	const float *gesture;
+	float query[GESTURE_DIMENSIONS];
+	float offset[GESTURE_DIMENSIONS];
+	// results so far, nearest first
+	int k;
+	int found;
+	int *result;
+	float *distance;
+	// compare projections only
+	bool projected;
+} GESTURE_SEARCH;
+
+// Weighted squared distance from the query to indexed gesture 'g'.
+static inline float gesture_index_distance(const GESTURE_INDEX *x, const float *gesture, int g)
+{
+	const float *p = x->data + size_t(g) * x->stride * x->channels;
+	float distance = 0;
+	for (int i = 0; i < x->length; ++i)
+	{
+		float window = x->weight[i];
+		for (int c = 0; c < x->channels; ++c)
+		{
+			float delta = gesture[i * x->channels + c] - p[i * x->channels + c];
+			distance += window * delta * delta;
+		}
+	}
+	return distance;
+}
+
+// Insert a result, keeping the 'k' nearest.
+static inline void gesture_search_insert(GESTURE_SEARCH *s, int g, float distance)
+{
+	int j = s->found < s->k ? s->found++ : s->k - 1;
+	while (j > 0 && distance < s->distance[j - 1])
+	{
+		s->distance[j] = s->distance[j - 1];
+		s->result[j] = s->result[j - 1];
+		--j;
+	}
+	s->distance[j] = distance;
+	s->result[j] = g;
+}
+
+// Search node 'k' covering order[lo..hi), whose projections are at least
+// 'bound' from the query's (squared), with 's->offset' the per-axis parts.
+static inline void gesture_search_node(GESTURE_SEARCH *s, int k, int lo, int hi, float bound)
+{
+	const GESTURE_INDEX *x = s->index;
+	// (slightly conservative, for rounding in the projections)
+	if (s->found == s->k && bound * 0.999f > s->distance[s->k - 1])
+	{
+		return;
+	}
+	if (hi - lo <= GESTURE_LEAF)
+	{
+		for (int i = lo; i < hi; ++i)
+		{
+			int g = x->order[i];
+			const float *p = x->point + g * GESTURE_DIMENSIONS;
+			float d = 0;
+			for (int a = 0; a < GESTURE_DIMENSIONS; ++a)
+			{
+				float delta = p[a] - s->query[a];
+				d += delta * delta;
+			}
+			if (s->found < s->k || d * 0.999f <= s->distance[s->k - 1])
+			{
+				if (! s->projected)
+				{
+					d = gesture_index_distance(x, s->gesture, g);
+				}
+				if (s->found < s->k || d < s->distance[s->k - 1])
+				{
+					gesture_search_insert(s, g, d);
+				}
+			}
+		}
+		return;
+	}
+	int mid = (lo + hi) / 2;
+	int a = x->axis[k];
+	float delta = s->query[a] - x->split[k];
+	float old = s->offset[a];
+	float far = bound - old * old + delta * delta;
+	if (delta < 0)
+	{
+		gesture_search_node(s, 2 * k + 1, lo, mid, bound);
+		s->offset[a] = delta;
+		gesture_search_node(s, 2 * k + 2, mid, hi, far);
+	}
+	else
+	{
+		gesture_search_node(s, 2 * k + 2, mid, hi, bound);
+		s->offset[a] = delta;
+		gesture_search_node(s, 2 * k + 1, lo, mid, far);
+	}
+	s->offset[a] = old;
+}
+
+// Find the 'k' indexed gestures nearest to 'gesture' ('length' frames
+// of 'channels' interleaved samples), storing their numbers (starting
+// at frame number * stride) in 'result' and their distances in
+// 'distance', nearest first.  Returns the number found (less than 'k'
+// only if fewer are indexed).
+// With 'rerank' 0 the search is exact.  Otherwise it is approximate:
+// the 'rerank' (at least 'k') nearest by projection are reranked by
+// true distance.
+static inline int gesture_index_search(const GESTURE_INDEX *x, const float *gesture, int k, int rerank, int *result, float *distance)
+{
+	if (x->count <= 0 || k <= 0)
+	{
+		return 0;
+	}
+	const int channels = x->channels, m = x->length * channels;
+	GESTURE_SEARCH s;
+	s.index = x;
+	s.gesture = gesture;
+	for (int d = 0; d < GESTURE_DIMENSIONS; ++d)
+	{
+		const float *v = x->basis + d * m;
+		float sum = 0;
+		for (int i = 0; i < m; ++i)
+		{
+			sum += v[i] * (x->root[i / channels] * gesture[i] - x->mean[i]);
+		}
+		s.query[d] = sum;
+		s.offset[d] = 0;
+	}
+	s.found = 0;
+	if (rerank <= 0)
+	{
+		s.k = k;
+		s.result = result;
+		s.distance = distance;
+		s.projected = false;
+		gesture_search_node(&s, 0, 0, x->count, 0);
+		return s.found;
+	}
+	// approximate
+	int candidate[GESTURE_RERANK_MAX];
+	float candidateDistance[GESTURE_RERANK_MAX];
+	rerank = rerank > k ? rerank : k;
+	s.k = rerank < GESTURE_RERANK_MAX ? rerank : GESTURE_RERANK_MAX;
+	s.result = candidate;
+	s.distance = candidateDistance;
+	s.projected = true;
+	gesture_search_node(&s, 0, 0, x->count, 0);
+	int candidates = s.found;
+	s.k = k;
+	s.found = 0;
+	s.result = result;
+	s.distance = distance;
+	for (int i = 0; i < candidates; ++i)
+	{
+		float d = gesture_index_distance(x, gesture, candidate[i]);
+		if (s.found < s.k || d < s.distance[s.k - 1])
+		{
+			gesture_search_insert(&s, candidate[i], d);
+		}
+	}
+	return s.found;
+}
+
+//---------------------------------------------------------------------
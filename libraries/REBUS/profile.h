@@ -0,0 +1,273 @@
+#pragma once
+
+//---------------------------------------------------------------------
+// windowed squared-distance profiles
+// 2026-10-16
+//
+// the distance from a query gesture ('length' frames of 'channels'
+// control signals) to the gesture at every offset of a long recording,
+// with the squared difference weighted per frame by a window:
+//
+//   D(g) = sum_i w[i] sum_c (q[i][c] - x[g + i][c])^2
+//        = sum_i w[i] |q[i]|^2 + E(g) - 2 sum_i w[i] q[i] . x[g + i]
+//
+// (as MASS, for matrix profiles).  the energies E(g) of the recording
+// are computed once, and the cross-correlation for all offsets at once
+// by FFT (overlap-save, blocks of the recording transformed once),
+// in O(n log length) instead of O(n length) per query.
+// channels are paired as real and imaginary parts of complex signals,
+// so 2 channels need one FFT per block.
+//
+// the result is rounded differently from summing directly:
+// near zero, distances have an error of about 1e-6 of the energies.
+//
+// the recording must stay unchanged while the profile is in use.
+
+#include <math.h>
+#include <string.h>
+#include <new>
+
+//---------------------------------------------------------------------
+// profile state
+
+typedef struct
+{
+	int length;
+	int channels;
+	// channel pairs (the last may have only one channel)
+	int pairs;
+	// FFT size, a power of two, and offsets per block
+	int size;
+	int hop;
+	// number of offsets profiled, at most 'capacity'
+	int count;
+	int capacity;
+	int blocks;
+	// per-frame weights, 'length' values
+	const float *weight;
+	// FFT twiddle factors, size / 2 complex values
+	float *twiddle;
+	// transformed recording, 'blocks' * 'pairs' * 'size' complex values
+	float *spectrum;
+	// weighted energy at each offset
+	float *energy;
+	// transformed query ('pairs' * 'size' complex values),
+	// and workspace ('size' complex values)
+	float *query;
+	float *work;
+} DISTANCE_PROFILE;
+
+//---------------------------------------------------------------------
+// FFT (complex, in place, interleaved real and imaginary parts)
+
+// Transform 'size' complex values (inverse: without the 1 / size scaling).
+static inline void distance_profile_fft(const DISTANCE_PROFILE *p, float *z, bool inverse)
+{
+	const int n = p->size;
+	// bit reversal permutation
+	for (int i = 1, j = 0; i < n; ++i)
+	{
+		int bit = n >> 1;
+		for (; j & bit; bit >>= 1)
+		{
+			j ^= bit;
+		}
+		j ^= bit;
+		if (i < j)
+		{
+			float re = z[2 * i], im = z[2 * i + 1];
+			z[2 * i] = z[2 * j];
+			z[2 * i + 1] = z[2 * j + 1];
+			z[2 * j] = re;
+			z[2 * j + 1] = im;
+		}
+	}
+	// butterflies
+	const float sign = inverse ? -1.0f : 1.0f;
+	for (int half = 1, stride = n >> 1; half < n; half <<= 1, stride >>= 1)
+	{
+		for (int start = 0; start < n; start += 2 * half)
+		{
+			for (int k = 0; k < half; ++k)
+			{
+				float wr = p->twiddle[2 * k * stride];
+				float wi = sign * p->twiddle[2 * k * stride + 1];
+				float *a = z + 2 * (start + k);
+				float *b = a + 2 * half;
+				float re = b[0] * wr - b[1] * wi;
+				float im = b[0] * wi + b[1] * wr;
+				b[0] = a[0] - re;
+				b[1] = a[1] - im;
+				a[0] += re;
+				a[1] += im;
+			}
+		}
+	}
+}
+
+//---------------------------------------------------------------------
+// setup and cleanup (not realtime safe: allocates memory)
+
+// Free the profile memory.
+static inline void distance_profile_cleanup(DISTANCE_PROFILE *p)
+{
+	delete[] p->twiddle;
+	delete[] p->spectrum;
+	delete[] p->energy;
+	delete[] p->query;
+	delete[] p->work;
+	memset(p, 0, sizeof(*p));
+}
+
+// Allocate a profile for up to 'capacity' offsets.
+// Returns false if memory could not be allocated.
+static inline bool distance_profile_setup(DISTANCE_PROFILE *p, int capacity, int length, int channels)
+{
+	memset(p, 0, sizeof(*p));
+	// about 8 times the gesture length costs the least per offset
+	int size = 2;
+	while (size < 8 * length)
+	{
+		size <<= 1;
+	}
+	int pairs = (channels + 1) / 2;
+	int hop = size - length + 1;
+	int blocks = (capacity + hop - 1) / hop;
+	p->twiddle = new(std::nothrow) float[size];
+	p->spectrum = new(std::nothrow) float[size_t(blocks) * pairs * size * 2];
+	p->energy = new(std::nothrow) float[capacity];
+	p->query = new(std::nothrow) float[size_t(pairs) * size * 2];
+	p->work = new(std::nothrow) float[size * 2];
+	if (! p->twiddle || ! p->spectrum || ! p->energy || ! p->query || ! p->work)
+	{
+		distance_profile_cleanup(p);
+		return false;
+	}
+	for (int k = 0; k < size / 2; ++k)
+	{
+		p->twiddle[2 * k] = cos(2 * M_PI * k / size);
+		p->twiddle[2 * k + 1] = -sin(2 * M_PI * k / size);
+	}
+	p->length = length;
+	p->channels = channels;
+	p->pairs = pairs;
+	p->size = size;
+	p->hop = hop;
+	p->capacity = capacity;
+	return true;
+}
+
+//---------------------------------------------------------------------
+// building (not realtime safe: takes time proportional to the count,
+// so run it in an auxiliary task; does not allocate memory)
+
+// Prepare to profile the 'count' offsets of 'data' (which must have
+// at least count + length - 1 frames of 'channels' interleaved samples),
+// weighted by 'weight'.
+static inline void distance_profile_build(DISTANCE_PROFILE *p, const float *data, const float *weight, int count)
+{
+	const int length = p->length, channels = p->channels, size = p->size;
+	count = count < p->capacity ? count : p->capacity;
+	p->weight = weight;
+	p->count = 0;
+	if (count <= 0)
+	{
+		return;
+	}
+	const int frames = count + length - 1;
+	// energies
+	for (int g = 0; g < count; ++g)
+	{
+		const float *x = data + size_t(g) * channels;
+		float e = 0;
+		for (int i = 0; i < length; ++i)
+		{
+			float s = 0;
+			for (int c = 0; c < channels; ++c)
+			{
+				s += x[i * channels + c] * x[i * channels + c];
+			}
+			e += weight[i] * s;
+		}
+		p->energy[g] = e;
+	}
+	// transform overlapping blocks of the recording
+	p->blocks = (count + p->hop - 1) / p->hop;
+	for (int b = 0; b < p->blocks; ++b)
+	{
+		for (int pair = 0; pair < p->pairs; ++pair)
+		{
+			float *z = p->spectrum + (size_t(b) * p->pairs + pair) * size * 2;
+			for (int j = 0; j < size; ++j)
+			{
+				int frame = b * p->hop + j;
+				int c = 2 * pair;
+				bool inside = frame < frames;
+				z[2 * j] = inside ? data[size_t(frame) * channels + c] : 0.0f;
+				z[2 * j + 1] = inside && c + 1 < channels ? data[size_t(frame) * channels + c + 1] : 0.0f;
+			}
+			distance_profile_fft(p, z, false);
+		}
+	}
+	p->count = count;
+}
+
+//---------------------------------------------------------------------
+// profiling (realtime safe, takes time proportional to the count)
+
+// Compute the distance from 'gesture' ('length' frames of 'channels'
+// interleaved samples) to the gesture at every offset,
+// storing them in 'distance' (the count set by distance_profile_build()).
+static inline void distance_profile_compute(DISTANCE_PROFILE *p, const float *gesture, float *distance)
+{
+	const int length = p->length, channels = p->channels, size = p->size;
+	if (p->count <= 0)
+	{
+		return;
+	}
+	// energy and transform of the weighted query
+	float energy = 0;
+	for (int pair = 0; pair < p->pairs; ++pair)
+	{
+		float *z = p->query + size_t(pair) * size * 2;
+		memset(z, 0, sizeof(float) * size * 2);
+		int c = 2 * pair;
+		for (int i = 0; i < length; ++i)
+		{
+			float re = gesture[i * channels + c];
+			float im = c + 1 < channels ? gesture[i * channels + c + 1] : 0.0f;
+			energy += p->weight[i] * (re * re + im * im);
+			z[2 * i] = p->weight[i] * re;
+			z[2 * i + 1] = p->weight[i] * im;
+		}
+		distance_profile_fft(p, z, false);
+	}
+	// cross-correlate each block: the first 'hop' outputs are valid
+	const float scale = -2.0f / size;
+	for (int b = 0; b < p->blocks; ++b)
+	{
+		float *w = p->work;
+		memset(w, 0, sizeof(float) * size * 2);
+		for (int pair = 0; pair < p->pairs; ++pair)
+		{
+			const float *q = p->query + size_t(pair) * size * 2;
+			const float *x = p->spectrum + (size_t(b) * p->pairs + pair) * size * 2;
+			// conj(q) * x
+			for (int k = 0; k < size; ++k)
+			{
+				w[2 * k] += q[2 * k] * x[2 * k] + q[2 * k + 1] * x[2 * k + 1];
+				w[2 * k + 1] += q[2 * k] * x[2 * k + 1] - q[2 * k + 1] * x[2 * k];
+			}
+		}
+		distance_profile_fft(p, w, true);
+		int first = b * p->hop;
+		int last = first + p->hop < p->count ? first + p->hop : p->count;
+		for (int g = first; g < last; ++g)
+		{
+			float d = energy + p->energy[g] + scale * w[2 * (g - first)];
+			distance[g] = d > 0 ? d : 0;
+		}
+	}
+}
+
+//---------------------------------------------------------------------
@@ -0,0 +1,127 @@
+#pragma once
+
+//---------------------------------------------------------------------
+// single producer single consumer lock-free ring buffer
+// 2026-10-16
+//
+// used by REBUS to pass interleaved recording data
+// from the realtime audio thread to the non-realtime file writer
+// without copying it through an intermediate buffer or pipe:
+// the producer writes frames directly into ring slots,
+// and the consumer hands contiguous runs of slots to the writer.
+//
+// exactly one thread may call the producer functions
+// and exactly one (other) thread may call the consumer functions;
+// setup and cleanup must not run concurrently with either.
+
+#include <atomic>
+#include <stddef.h>
+#include <cstdint>
+#include <new>
+
+//---------------------------------------------------------------------
+// ring buffer state
+
+typedef struct
+{
+	// interleaved data, 'frames' * 'channels' floats
+	float *data;
+	// capacity in frames, a power of two
+	uint32_t frames;
+	// samples per frame
+	uint32_t channels;
+	// total frames written, updated by the producer
+	// (free-running: wraps around, indices are masked)
+	std::atomic<uint32_t> write;
+	// total frames read, updated by the consumer
+	std::atomic<uint32_t> read;
+} RING;
+
+//---------------------------------------------------------------------
+// setup and cleanup (not realtime safe: allocates memory)
+
+// Allocate a ring for at least 'frames' frames of 'channels' samples.
+// Returns false if memory could not be allocated.
+static inline bool ring_setup(RING *r, uint32_t frames, uint32_t channels)
+{
+	uint32_t capacity = 1;
+	while (capacity < frames && capacity < (1u << 30))
+	{
+		capacity <<= 1;
+	}
+	r->data = new(std::nothrow) float[size_t(capacity) * channels]();
+	r->frames = r->data ? capacity : 0;
+	r->channels = channels;
+	r->write.store(0, std::memory_order_relaxed);
+	r->read.store(0, std::memory_order_relaxed);
+	return r->data != nullptr;
+}
+
+// Free the ring memory.
+static inline void ring_cleanup(RING *r)
+{
+	delete[] r->data;
+	r->data = nullptr;
+	r->frames = 0;
+}
+
+//---------------------------------------------------------------------
+// producer side (realtime safe)
+
+// Number of frames that can be written without overwriting unread data.
+static inline uint32_t ring_writable(const RING *r)
+{
+	uint32_t write = r->write.load(std::memory_order_relaxed);
+	uint32_t read = r->read.load(std::memory_order_acquire);
+	return r->frames - (write - read);
+}
+
+// Number of frames written but not yet read.
+static inline uint32_t ring_pending(const RING *r)
+{
+	uint32_t write = r->write.load(std::memory_order_relaxed);
+	uint32_t read = r->read.load(std::memory_order_acquire);
+	return write - read;
+}
+
+// Pointer to the interleaved slot for frame 'offset' after the write position.
+// 'offset' must be less than ring_writable().
+static inline float *ring_frame(RING *r, uint32_t offset)
+{
+	uint32_t write = r->write.load(std::memory_order_relaxed);
+	return &r->data[size_t((write + offset) & (r->frames - 1)) * r->channels];
+}
+
+// Publish 'frames' frames written via ring_frame() to the consumer.
+static inline void ring_commit(RING *r, uint32_t frames)
+{
+	uint32_t write = r->write.load(std::memory_order_relaxed);
+	r->write.store(write + frames, std::memory_order_release);
+}
+
+//---------------------------------------------------------------------
+// consumer side
+
+// Get the longest contiguous run of readable frames,
+// storing a pointer to its first sample in 'p'.
+// Returns the number of frames (0 if the ring is empty).
+// Call again after ring_release() for data that wrapped around.
+static inline uint32_t ring_readable(RING *r, const float **p)
+{
+	uint32_t read = r->read.load(std::memory_order_relaxed);
+	uint32_t write = r->write.load(std::memory_order_acquire);
+	uint32_t index = read & (r->frames - 1);
+	uint32_t available = write - read;
+	uint32_t contiguous = r->frames - index;
+	*p = &r->data[size_t(index) * r->channels];
+	return available < contiguous ? available : contiguous;
+}
+
+// Give 'frames' frames returned by ring_readable() back to the producer.
+static inline void ring_release(RING *r, uint32_t frames)
+{
+	uint32_t read = r->read.load(std::memory_order_relaxed);
+	r->read.store(read + frames, std::memory_order_release);
+}
+
+//---------------------------------------------------------------------
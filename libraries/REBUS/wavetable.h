@@ -0,0 +1,239 @@
+#pragma once
+
+//---------------------------------------------------------------------
+// mipmapped band-limited wavetable oscillators
+// 2026-10-16
+//
+// a single-cycle waveform is analysed once at setup (by DFT)
+// and resynthesized into one table per octave, each with only
+// as many harmonics as can be played in that octave without aliasing.
+// playback picks the two tables for the oscillator frequency
+// and crossfades between them, so the brightness changes smoothly
+// as the frequency sweeps.
+//
+// tables have a power of two size, so the 32bit phase (see dsp.h
+// phasor32() and dsp_simd.h OSC4/OSC8) splits directly into
+// table index (top bits) and interpolation fraction (bottom bits),
+// with no wrapping or range checks.
+//
+// the band limit is at a quarter to half of the sample rate
+// (depending on where the frequency is within the octave),
+// so waveforms lose some brightness in the top octaves.
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <new>
+#include "dsp_simd.h"
+
+// log2 of the table size, '#define WAVETABLE_BITS 12' before including
+// for 4096 point tables (more harmonics for very low frequencies).
+#ifndef WAVETABLE_BITS
+#define WAVETABLE_BITS 11
+#endif
+
+// Table size in samples.
+#define WAVETABLE_SIZE (1 << WAVETABLE_BITS)
+
+// Number of tables: table 'j' has harmonics up to (WAVETABLE_SIZE / 2) >> j,
+// down to a single sine.
+#define WAVETABLE_LEVELS WAVETABLE_BITS
+
+//---------------------------------------------------------------------
+// wavetable state
+
+typedef struct
+{
+	// WAVETABLE_LEVELS tables of WAVETABLE_SIZE + 1 samples each
+	// (the last sample of each table repeats the first,
+	// so interpolation never needs to wrap)
+	float *data;
+} WAVETABLE;
+
+//---------------------------------------------------------------------
+// setup and cleanup (not realtime safe: allocates memory)
+
+// Build the tables from one cycle of 'wave', 'length' samples long
+// (any length, harmonics above length / 2 are ignored).
+// Returns false if memory could not be allocated.
+static inline bool wavetable_setup(WAVETABLE *w, const float *wave, int length)
+{
+	const int size = WAVETABLE_SIZE;
+	int harmonics = length / 2 < size / 2 ? length / 2 : size / 2;
+	w->data = new(std::nothrow) float[WAVETABLE_LEVELS * (size + 1)];
+	double *scratch = new(std::nothrow) double[2 * length + 3 * size + 2 * (harmonics + 1)];
+	if (! w->data || ! scratch)
+	{
+		delete[] w->data;
+		delete[] scratch;
+		w->data = nullptr;
+		return false;
+	}
+	double *c = scratch, *s = c + length; // analysis cos/sin tables
+	double *cs = s + length, *ss = cs + size; // synthesis cos/sin tables
+	double *acc = ss + size; // resynthesis
+	double *re = acc + size, *im = re + harmonics + 1; // harmonics
+	for (int i = 0; i < length; ++i)
+	{
+		c[i] = cos(2 * M_PI * i / length);
+		s[i] = sin(2 * M_PI * i / length);
+	}
+	for (int i = 0; i < size; ++i)
+	{
+		cs[i] = cos(2 * M_PI * i / size);
+		ss[i] = sin(2 * M_PI * i / size);
+	}
+	// analyse
+	for (int h = 0; h <= harmonics; ++h)
+	{
+		double a = 0, b = 0;
+		for (int i = 0; i < length; ++i)
+		{
+			int k = int((int64_t(h) * i) % length);
+			a += wave[i] * c[k];
+			b += wave[i] * s[k];
+		}
+		double scale = (h == 0 || 2 * h == length ? 1.0 : 2.0) / length;
+		re[h] = a * scale;
+		im[h] = b * scale;
+	}
+	// resynthesize, from the sine table up,
+	// each table adding the octave of harmonics above the previous one
+	for (int i = 0; i < size; ++i)
+	{
+		acc[i] = re[0];
+	}
+	int done = 0;
+	for (int j = WAVETABLE_LEVELS - 1; j >= 0; --j)
+	{
+		int top = (size / 2) >> j;
+		if (top > harmonics)
+		{
+			top = harmonics;
+		}
+		for (int h = done + 1; h <= top; ++h)
+		{
+			for (int i = 0; i < size; ++i)
+			{
+				int k = (h * i) & (size - 1);
+				acc[i] += re[h] * cs[k] + im[h] * ss[k];
+			}
+		}
+		done = top;
+		float *table = w->data + j * (size + 1);
+		for (int i = 0; i < size; ++i)
+		{
+			table[i] = acc[i];
+		}
+		table[size] = table[0];
+	}
+	delete[] scratch;
+	return true;
+}
+
+// Free the tables.
+static inline void wavetable_cleanup(WAVETABLE *w)
+{
+	delete[] w->data;
+	w->data = nullptr;
+}
+
+//---------------------------------------------------------------------
+// playback (realtime safe)
+
+// Read the wavetable at 32bit phase 'phase' (2^32 is one cycle),
+// band-limited for an oscillator at frequency 'hz'.
+static inline float wavetable_read(const WAVETABLE *w, uint32_t phase, float hz)
+{
+	// octave above the sine table, as float exponent and (approximate) fraction
+	float x = fabsf(hz) * rate().isrf * float(2 * WAVETABLE_SIZE);
+	uint32_t b;
+	memcpy(&b, &x, sizeof(b));
+	int j = int(b >> 23) - 127;
+	b = (b & 0x007fffff) | 0x3f800000;
+	float f;
+	memcpy(&f, &b, sizeof(f));
+	f -= 1.0f;
+	if (j < 0)
+	{
+		j = 0;
+		f = 0.0f;
+	}
+	if (j >= WAVETABLE_LEVELS - 1)
+	{
+		j = WAVETABLE_LEVELS - 1;
+		f = 0.0f;
+	}
+	int k = j + 1 < WAVETABLE_LEVELS ? j + 1 : j;
+	// table index and interpolation fraction
+	int i = phase >> (32 - WAVETABLE_BITS);
+	float t = ((phase << WAVETABLE_BITS) >> 8) * 5.9604644775390625e-8f; // 2^-24
+	const float *p = w->data + j * (WAVETABLE_SIZE + 1) + i;
+	const float *q = w->data + k * (WAVETABLE_SIZE + 1) + i;
+	float y0 = p[0] + t * (p[1] - p[0]);
+	float y1 = q[0] + t * (q[1] - q[0]);
+	return y0 + f * (y1 - y0);
+}
+
+// Advance the phasor 'p' at frequency 'hz' and read the wavetable.
+static inline float wavetable(const WAVETABLE *w, PHASOR32 *p, float hz)
+{
+	p->phase += (uint32_t) (int32_t) (hz * rate().pincf);
+	return wavetable_read(w, p->phase, hz);
+}
+
+//---------------------------------------------------------------------
+// vectorized playback, for banks of oscillators (realtime safe)
+//
+// the same as wavetable_read() per element,
+// with dsp_simd.h OSC4/OSC8 holding the phases
+// (the 'width' of the bank functions is not used).
+
+// sample8 is passed by value without AVX, which GCC warns about
+#if defined(__GNUC__) && ! defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+struct OSC_WAVETABLE
+{
+	const float *data;
+	template <typename V, typename I>
+	V operator()(const I &p, const V &dt, const V &, const I &) const
+	{
+		V zero = vsplat<V>(0.0f);
+		V last = vsplat<V>(float(WAVETABLE_LEVELS - 1));
+		I b = vbits(dt * vsplat<V>(float(2 * WAVETABLE_SIZE)));
+		V e = vtofloat(vshr<23>(b) - visplat<I>(127));
+		V f = vunbits((b & visplat<I>(0x007fffff)) | visplat<I>(0x3f800000)) - vsplat<V>(1.0f);
+		f = vselect(e, zero, zero, f);
+		f = vselect(e, last, f, zero);
+		V j = vmin(vmax(e, zero), last);
+		V k = vmin(j + vsplat<V>(1.0f), last);
+		I i = vshr<32 - WAVETABLE_BITS>(p);
+		V t = vtofloat(vshr<8>(vshl<WAVETABLE_BITS>(p))) * vsplat<V>(5.9604644775390625e-8f); // 2^-24
+		I pj = vtoint(j * vsplat<V>(float(WAVETABLE_SIZE + 1))) + i;
+		I pk = vtoint(k * vsplat<V>(float(WAVETABLE_SIZE + 1))) + i;
+		V a0 = vgather<V>(data, pj, -1);
+		V a1 = vgather<V>(data, pj + visplat<I>(1), -1);
+		V b0 = vgather<V>(data, pk, -1);
+		V b1 = vgather<V>(data, pk + visplat<I>(1), -1);
+		V y0 = a0 + t * (a1 - a0);
+		V y1 = b0 + t * (b1 - b0);
+		return y0 + f * (y1 - y0);
+	}
+};
+
+// Advance a bank of oscillators at frequencies 'hz' and read the wavetable
+// at phase offsets 'phase' (in cycles), times 'amplitude'.
+static inline sample4 wavetable4(const WAVETABLE *w, OSC4 *o, const sample4 &hz, const sample4 &phase, const sample4 &amplitude) { OSC_WAVETABLE k = { w->data }; return vosc(k, o->phase, hz, phase, amplitude, hz); }
+static inline sample8 wavetable8(const WAVETABLE *w, OSC8 *o, const sample8 &hz, const sample8 &phase, const sample8 &amplitude) { OSC_WAVETABLE k = { w->data }; return vosc(k, o->phase, hz, phase, amplitude, hz); }
+
+// Block version for large banks, see dsp_simd.h osc_sine_block().
+static inline void wavetable_block(const WAVETABLE *w, OSC8 *o, int banks, const float *hz, const float *phase, const float *amplitude, float *y, int n) { OSC_WAVETABLE k = { w->data }; vosc_block(k, o, banks, hz, phase, amplitude, nullptr, y, n); }
+
+#if defined(__GNUC__) && ! defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+//---------------------------------------------------------------------
@@ -28,9 +28,9 @@ The third dimension is stereo panning of the retrigger signal.
 
 #include <libraries/REBUS/REBUS.h>
 
-#include <complex>
-// ported from the pd-boids external plugin for Pure-data
-#include "boids3d.h"
+#include <libraries/REBUS/dsp_simd.h>
+// flock engine ported from the pd-boids external plugin for Pure-data
+#include <libraries/REBUS/flock.h>
 
 //---------------------------------------------------------------------
 // added to audio recording filename
@@ -40,25 +40,53 @@ const char *COMPOSITION_name = "boids";
 //---------------------------------------------------------------------
 // composition state
 
-// number of members of the flock
+// number of members of the flock (a multiple of 8)
 #define COUNT 8
 
+// flock update period in frames
+#define PERIOD 256
+
+// flock work per frame (grid sort items and boids, see flock.h),
+// so each step finishes within the period
+#define SLICE ((FLOCK_STEP_WORK(COUNT) + PERIOD - 1) / PERIOD)
+
+// oscillator retune period in frames (divides PERIOD),
+// the ramp towards the flock is in PERIOD / RETUNE steps
+#define RETUNE 16
+
 struct COMPOSITION
 {
 	// the flock
 	t_boids *boids;
-	// oscillator speed
-	std::complex<float> increment[COUNT];
-	// oscillator state
-	std::complex<float> oscillator[COUNT];
-	// oscillator retrigger offset
-	std::complex<float> trigger[COUNT];
-	// envelope follower
-	float rms[COUNT];
+	// oscillator parameters, ramping towards the flock every RETUNE frames
+	// (log of decay per sample, and frequency in radians per sample)
+	float decay[COUNT], decayStep[COUNT];
+	float frequency[COUNT], frequencyStep[COUNT];
+	// oscillators, 8 per bank
+	COSC8 oscillator[COUNT / 8];
 	// counter
 	int n;
 };
 
+//---------------------------------------------------------------------
+// oscillator parameters for the flock positions
+
+inline
+void COMPOSITION_targets(struct COMPOSITION *C, float decay[COUNT], float frequency[COUNT], float amplitude[COUNT], float angle[COUNT])
+{
+	for (int i = 0; i < COUNT; ++i)
+	{
+		// exponential gain mapping controls decay time (and retrigger rate)
+		float gain = constrain(C->boids->newPos.x[i], 0.0f, 1.0f);
+		decay[i] = map(gain, 0.0f, 1.0f, logf(0.99f), logf(0.999999f));
+		// linear phase mapping controls frequency
+		frequency[i] = 0.25f * constrain(C->boids->newPos.y[i], 0.0f, 1.0f);
+		// third dimension controls panning of trigger
+		amplitude[i] = 0.5f;
+		angle[i] = 0.5f * 3.141592653f * C->boids->newPos.z[i];
+	}
+}
+
 //---------------------------------------------------------------------
 // called during setup
 
@@ -75,14 +103,12 @@ bool COMPOSITION_setup(BelaContext *context, struct COMPOSITION *C)
 	Flock_attractWeight(C->boids, 10.0);
 	Flock_resetBoids(C->boids);
 	// initialize oscillators
-	for (int i = 0; i < COUNT; ++i)
-	{
-		C->increment[i] = 0;
-		C->oscillator[i] = 0;
-		C->trigger[i] = 0;
-		C->rms[i] = 0;
-	}
-	// initialize counter (the flock is not updated every sample)
+	std::memset(C->oscillator, 0, sizeof(C->oscillator));
+	float a[COUNT], t[COUNT];
+	COMPOSITION_targets(C, C->decay, C->frequency, a, t);
+	std::memset(C->decayStep, 0, sizeof(C->decayStep));
+	std::memset(C->frequencyStep, 0, sizeof(C->frequencyStep));
+	// initialize counter (the flock is stepped once per period)
 	C->n = 0;
 	return true;
 }
@@ -92,9 +118,9 @@ inline
 void COMPOSITION_boids(BelaContext *context, struct COMPOSITION *C,
   float magnitude, float phase)
 {
-	// set the target and update the flock
+	// set the target and start updating the flock
 	Flock_attractPt(C->boids, magnitude, phase, 0.5f);
-	FlightStep(C->boids);
+	FlightStepStart(C->boids);
 }
 
 //---------------------------------------------------------------------
@@ -105,54 +131,55 @@ void COMPOSITION_render(BelaContext *context, struct COMPOSITION *C, int n,
   float out[2], const float in[2], const float magnitude, const float phase)
 {
 	// update the flock
+	// the cost of each step is spread over the period,
+	// and the oscillators ramp to the positions of the previous step,
+	// so the work per frame is about the same
 	if (C->n == 0)
 	{
+		// ramp the oscillators to the flock
+		float m[COUNT], f[COUNT], a[COUNT], t[COUNT];
+		COMPOSITION_targets(C, m, f, a, t);
+		for (int i = 0; i < COUNT; ++i)
+		{
+			C->decayStep[i] = (m[i] - C->decay[i]) * (float(RETUNE) / PERIOD);
+			C->frequencyStep[i] = (f[i] - C->frequency[i]) * (float(RETUNE) / PERIOD);
+		}
+		cosc_trigger_block(C->oscillator, COUNT / 8, a, t);
 		COMPOSITION_boids(context, C, magnitude, phase);
-		// update the oscillators corresponding to the boids
+	}
+	FlightStepContinue(C->boids, SLICE);
+	// update the oscillators corresponding to the boids
+	// (retuning every frame would cost more than the flock)
+	if (C->n % RETUNE == 0)
+	{
+		float m[COUNT];
 		for (int i = 0; i < COUNT; ++i)
 		{
-			// exponential gain mapping controls decay time (and retrigger rate)
-			float gain = constrain(C->boids->boid[i].newPos.x, 0.0f, 1.0f);
-			float m = expf(map(gain, 0.0f, 1.0f, logf(0.99f), logf(0.999999f)));
-			// linear phase mapping controls frequency
-			float f = 0.25f * constrain(C->boids->boid[i].newPos.y, 0.0f, 1.0f);
-			// third dimension controls panning of trigger
-			float t = 0.5f * 3.141592653f * C->boids->boid[i].newPos.z;
-			C->increment[i] = m * std::complex<float>(std::cos(f), std::sin(f));
-			C->trigger[i] = 0.5f * std::complex<float>(std::cos(t), std::sin(t));
+			C->decay[i] += C->decayStep[i];
+			C->frequency[i] += C->frequencyStep[i];
 		}
+		// vectorised maps for all boids at once
+		exp_block(m, C->decay, COUNT);
+		cosc_tune_block(C->oscillator, COUNT / 8, m, C->frequency);
 	}
-	// Flock update rate: once every 256 samples
-	if (++C->n >= 256)
+	if (++C->n >= PERIOD)
 	{
 		C->n = 0;
 	}
 
 	// accumulate the oscillators
+	// each has a root-mean-square envelope follower
+	// and is retriggered when it's quiet
+	// (no square root necessary: both sides are squared)
 	out[0] = 0;
 	out[1] = 0;
-	for (int i = 0; i < COUNT; ++i)
-	{
-		// root-mean-square envelope follower
-		C->rms[i] *= 0.99;
-		C->rms[i] += 0.01 * std::norm(C->oscillator[i]);
-		// no square root necessary: both sides are squared
-		// compare against threshold
-		if (C->rms[i] < 3.0e-3f)
-		{
-			// it's quiet, so retrigger it
-			C->oscillator[i] += C->trigger[i];
-		}
-		C->oscillator[i] *= C->increment[i];
-		out[0] += C->oscillator[i].real();
-		out[1] += C->oscillator[i].imag();
-	}
+	cosc_block(C->oscillator, COUNT / 8, 3.0e-3f, &out[0], &out[1], 1);
 	out[0] /= COUNT;
 	out[1] /= COUNT;
 
 	// soft-clip the output
-	out[0] = std::tanh(out[0]);
-	out[1] = std::tanh(out[1]);
+	out[0] = fasttanh(out[0]);
+	out[1] = fasttanh(out[1]);
 }
 
 //---------------------------------------------------------------------
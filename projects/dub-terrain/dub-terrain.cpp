@@ -24,9 +24,10 @@ Phase controls stereo rotation of the feedback and filter frequencies.
 
 #include <libraries/REBUS/REBUS.h>
 
-// ARM Neon SIMD does 4 calculations in 1 without costing much more.
+// SIMD does 4 calculations in 1 without costing much more.
 // Using this makes this composition computationally feasible.
-#include <libraries/REBUS/dsp_neon.h>
+// (ARM Neon on Bela, SSE on x86 hosts)
+#include <libraries/REBUS/dsp_simd.h>
 
 //---------------------------------------------------------------------
 // added to audio recording filename
@@ -39,8 +40,8 @@ const char *COMPOSITION_name = "dub-terrain";
 // delay line
 struct DLINE
 {
-	DELAY del; // delay ugen control data
-	float buf[1 << 17]; // delay buffer
+	MDELAY del; // delay ugen control data
+	float buf[1 << 17]; // delay buffer (power of two length)
 };
 
 // composition
@@ -48,10 +49,9 @@ struct COMPOSITION
 {
 	// ramps once per bar, used for kick
 	PHASOR clock;
-	// resonant filter for bass
-	BIQUAD bass;
-	// resonant filter for sub
-	BIQUAD sub;
+	// resonant filters for bass (lane 0) and sub (lane 1)
+	BIQUAD4_COEFFS drums;
+	BIQUAD4_STATE drumsState;
 	// delay lines for feedback (stereo)
 	DLINE del[2];
 	// four parallel bandpass filters (stereo)
@@ -64,24 +64,20 @@ struct COMPOSITION
 inline
 bool COMPOSITION_setup(BelaContext *context, struct COMPOSITION *C)
 {
-	if (context->audioSampleRate != SR)
-	{
-		rt_printf("Sample rate mismatch: using %f, expected %f\n",
-			(double) context->audioSampleRate, (double) SR);
-		// return false; // FIXME should this be a hard error?
-		// pitch and tempo will not be as intended...
-	}
-
 	// clear the memory to 0
 	std::memset(C, 0, sizeof(*C));
 
 	// calculate resonant filter coefficients
-	highpass(&C->bass, 32, 20); // 32 Hz, Q 20
-	lowpass(&C->sub, 64, 50); // 64 Hz, Q 50
-
-	// set the length of the delay buffers (should match DLINE struct)
-	C->del[0].del.length = 1 << 17;
-	C->del[1].del.length = 1 << 17;
+	// (lanes 2 and 3 stay zero, so they output silence)
+	BIQUAD_COEFFS bq;
+	highpass(&bq, 32, 20); // 32 Hz, Q 20
+	biquad4_set(&C->drums, 0, &bq);
+	lowpass(&bq, 64, 50); // 64 Hz, Q 50
+	biquad4_set(&C->drums, 1, &bq);
+
+	// set the length of the delay buffers as a mask, length - 1 (should match DLINE struct)
+	C->del[0].del.mask = (1 << 17) - 1;
+	C->del[1].del.mask = (1 << 17) - 1;
 	return true;
 }
 
@@ -94,7 +90,7 @@ void COMPOSITION_render(BelaContext *context, struct COMPOSITION *C, int n,
 {
 	static const sample4 prime2pi =
 		{ 2 * float(2*M_PI), 3 * float(2*M_PI), 5 * float(2*M_PI), 7 * float(2*M_PI) };
-	const sample4 one = vmovq_n_f32(1.0f);
+	const sample4 one = splat4(1.0f);
 
 	// dry drum sounds
 	sample tempo = 0.4; // about 96bpm
@@ -110,50 +106,47 @@ void COMPOSITION_render(BelaContext *context, struct COMPOSITION *C, int n,
 	clock *= clock;
 	// the kick is a sine wave with decaying frequency (chirp)
 	sample kick = sinf(32 * float(M_PI) * clock);
-	// the bass is resonant high pass filtered
-	sample bass = kick - biquad(&C->bass, kick);
-	// the sub is resonant low pass filtered
-	sample sub = biquad(&C->sub, kick);
+	// the bass is resonant high pass filtered, the sub resonant low pass filtered
+	sample4 drums = biquad4(&C->drums, &C->drumsState, splat4(kick));
+	sample bass = kick - drums[0];
+	sample sub = drums[1];
 
 	// four channels of feedback with different delay times (stereo)
-	sample4 feedback0, feedback1;
+	sample4 ms;
 	for (int i = 0; i < 4; ++i)
 	{
-		feedback0[i] = delread1(&C->del[0].del, 1000 / tempo * 1 / (i + 1.5));
-		feedback1[i] = delread1(&C->del[1].del, 1000 / tempo * 1 / (i + 1.5));
+		ms[i] = 1000 / tempo * 1 / (i + 1.5);
 	}
+	sample4 feedback0 = mdelread1_4(&C->del[0].del, ms);
+	sample4 feedback1 = mdelread1_4(&C->del[1].del, ms);
 
 	// rotate delayed feedbacks in stereo field
 	// rotation angles are multiples of the phase control
 	// compute sine and cosine of four multiples of the REBUS antenna phase control
 	sample4 sinPhase, cosPhase;
-	sincos4(sinPhase, cosPhase, vmulq_n_f32(prime2pi, phase));
+	sincos4(sinPhase, cosPhase, prime2pi * splat4(phase));
 	// do four matrix-vector multiplications for the four channels
-	sample4 tmp0 = vsubq_f32(vmulq_f32(cosPhase, feedback0),
-	                         vmulq_f32(sinPhase, feedback1));
-	sample4 tmp1 = vaddq_f32(vmulq_f32(sinPhase, feedback0),
-	                         vmulq_f32(cosPhase, feedback1));
+	sample4 tmp0 = cosPhase * feedback0 - sinPhase * feedback1;
+	sample4 tmp1 = sinPhase * feedback0 + cosPhase * feedback1;
 	feedback0 = tmp0;
 	feedback1 = tmp1;
 
 	// calculate filter parameters (q, hz)
 	// compute sine and cosine of four multiples of the REBUS antenna magnitude control
 	sample4 sinMagnitude, ignored;
-	sincos4(sinMagnitude, ignored, vmulq_n_f32(prime2pi, magnitude));
+	sincos4(sinMagnitude, ignored, prime2pi * splat4(magnitude));
 	// filter q factor is constant for all of them
 	sample q = 3;
 	// filter frequency is based on multiples of the phase control
-	sample4 hz = mtof4(vaddq_f32(vmulq_n_f32(
-		vmulq_n_f32(vsubq_f32(one, cosPhase), 0.5f),
-		84.0f - 36.0f), vmovq_n_f32(36.0f)));
+	sample4 hz = mtof4((one - cosPhase) * splat4(0.5f * (84.0f - 36.0f)) + splat4(36.0f));
 	// permute the frequencies for a bit more variation
 	{ sample t = hz[3]; hz[3] = hz[0]; hz[0] = t; }
 	{ sample t = hz[2]; hz[2] = hz[1]; hz[1] = t; }
 
 	// four parallel bandpass filter for each of two channels
 	// the feedback gain is applied here too
-	feedback0 = vcf4(&C->bandpass[0], vmulq_f32(sinMagnitude, feedback0), hz, q);
-	feedback1 = vcf4(&C->bandpass[1], vmulq_f32(sinMagnitude, feedback1), hz, q);
+	feedback0 = vcf4(&C->bandpass[0], sinMagnitude * feedback0, hz, q);
+	feedback1 = vcf4(&C->bandpass[1], sinMagnitude * feedback1, hz, q);
 
 	// waveshaping / mixing
 	// overall non-feedback gain is based on the REBUS antenna magnitude control
@@ -166,8 +159,8 @@ void COMPOSITION_render(BelaContext *context, struct COMPOSITION *C, int n,
 		+ feedback1[0] + feedback1[1] + feedback1[2] + feedback1[3]);
 
 	// write the output to the delay lines for future feedback
-	delwrite(&C->del[0].del, out[0]);
-	delwrite(&C->del[1].del, out[1]);
+	mdelwrite(&C->del[0].del, out[0]);
+	mdelwrite(&C->del[1].del, out[1]);
 }
 
 //---------------------------------------------------------------------
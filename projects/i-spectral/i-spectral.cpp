@@ -28,6 +28,7 @@ Slower oscillating motion makes lower pitched sounds.
 #include <libraries/REBUS/REBUS.h>
 
 #include <libraries/REBUS/dsp.h>
+#include <libraries/REBUS/dsp_simd.h>
 #include <libraries/ne10/NE10.h>
 #include <complex>
 
@@ -41,6 +42,7 @@ const char *COMPOSITION_name = "i-spectral";
 
 #define BUFFER 65536 // bigger than BLOCK * 2, for overlap add
 #define BLOCK 1024 // power of 2, for FFT
+#define BINS (BLOCK / 2 + 1) // non-redundant bins of real FFT
 #define HOP 256
 #define OVERLAP (BLOCK / HOP)
 #define GAIN (4.0f * (0.5f / OVERLAP)) // waveshaper gain * overlap-add gain
@@ -61,6 +63,12 @@ struct COMPOSITION
 	float *block; //[BLOCK];
 	// raised cosine window
 	float *window; //[BLOCK];
+	// random phases for synthesis, and their sines and cosines
+	float *phase; //[BINS];
+	float *phaseSin; //[BINS];
+	float *phaseCos; //[BINS];
+	// random number generator for the phases
+	RNG8 rng;
 	// counts up to hop size
 	unsigned int sampleIx;
 	// ring buffer index for input buffer writing
@@ -78,6 +86,8 @@ struct COMPOSITION
 	AuxiliaryTask processTask;
 	// flag to detect too-slow computation
 	volatile bool inProcess;
+	// counts too-slow computation
+	OVERRUN *tooSlow;
 	// audio output DC blocking filter state (stereo)
 	float dc[2];
 	// phase input bandpasss filter
@@ -116,6 +126,17 @@ void COMPOSITION_process(void *)
 	// stereo sound synthesizer
 	for (unsigned int channel = 0; channel < 2; ++channel)
 	{
+		// paulstretch-style phase randomisation
+		// a bit spacier than a phase vocoder but no unpleasant artifacts
+		// and much easier to implement
+		// (random phases from -pi to pi for all bins at once)
+		rng_uniform_block(&C->rng, C->phase, BINS);
+		for (unsigned int n = 0; n < BINS; ++n)
+		{
+			C->phase[n] *= float(M_PI);
+		}
+		sincos_block(C->phaseSin, C->phaseCos, C->phase, BINS);
+
 		for (unsigned int n = 0; n < BLOCK; ++n)
 		{
 			// exploit symmetry of FFT of real-valued signal
@@ -129,11 +150,7 @@ void COMPOSITION_process(void *)
 			else
 			{
 				std::complex<float> spectrum(C->motion[n].r, C->motion[n].i);
-				// paulstretch-style phase randomisation
-				// a bit spacier than a phase vocoder but no unpleasant artifacts
-				// and much easier to implement
-				float p = 2.0f * 3.141592653f * rand() / (float) RAND_MAX;
-				spectrum *= std::complex<float>(std::cos(p), std::sin(p));
+				spectrum *= std::complex<float>(C->phaseCos[n], C->phaseSin[n]);
 				C->synth[n].r = spectrum.real();
 				C->synth[n].i = spectrum.imag();
 			}
@@ -179,6 +196,9 @@ bool COMPOSITION_setup(BelaContext *context, COMPOSITION *C)
 	NEW(C->synth, ne10_fft_cpx_float32_t, BLOCK)
 	NEW(C->block, float, BLOCK)
 	NEW(C->window, float, BLOCK)
+	NEW(C->phase, float, BINS)
+	NEW(C->phaseSin, float, BINS)
+	NEW(C->phaseCos, float, BINS)
 
 	// macro is no longer necessary
 #undef NEW
@@ -189,6 +209,12 @@ bool COMPOSITION_setup(BelaContext *context, COMPOSITION *C)
 		C->window[n] = (1 - std::cos(2 * M_PI * n / BLOCK)) / 2;
 	}
 
+	// seed the phases (the same every time, for reproducible renders)
+	rng8_seed(&C->rng, 1);
+
+	// count when the FFT task is too slow to finish before the next hop
+	C->tooSlow = REBUS_overrun("i-spectral fft task too slow");
+
 	// FFT task runs at lower priority possibly taking several DSP blocks to complete
 	C->outputIxW = HOP;
 	if (! (C->processTask = Bela_createAuxiliaryTask(&COMPOSITION_process, 90, "fft-process")))
@@ -239,7 +265,7 @@ void COMPOSITION_render(BelaContext *context, COMPOSITION *C, int n,
 		o -= C->dc[channel];
 
 		// write output with waveshaping
-		out[channel] = std::tanh(o);
+		out[channel] = fasttanh(o);
 
 		// reset for next overlap add
 		C->output[channel][(C->outputIxR + BUFFER / 2) % BUFFER] = 0;
@@ -259,7 +285,8 @@ void COMPOSITION_render(BelaContext *context, COMPOSITION *C, int n,
 		if (C->inProcess)
 		{
 			// the FFT task is still in progress, should not happen
-			rt_printf("TOO SLOW\n");
+			// counted and reported by REBUS with the status
+			REBUS_countOverrun(C->tooSlow);
 		}
 		else
 		{
@@ -284,6 +311,9 @@ void COMPOSITION_cleanup(BelaContext *context, COMPOSITION *C)
 		NE10_FREE(C->synth);
 		NE10_FREE(C->block);
 		NE10_FREE(C->window);
+		NE10_FREE(C->phase);
+		NE10_FREE(C->phaseSin);
+		NE10_FREE(C->phaseCos);
 	}
 	gC = nullptr;
 }
@@ -34,7 +34,10 @@ and set INPUTDURATION to its length in seconds (fractions allowed)
 
 #include <libraries/REBUS/REBUS.h>
 #include <libraries/REBUS/dsp.h>
+#include <libraries/REBUS/gesture.h>
+#include <libraries/REBUS/profile.h>
 #include <libraries/sndfile/sndfile.h>
+#include <unistd.h>
 
 //---------------------------------------------------------------------
 // added to audio recording filename
@@ -44,9 +47,13 @@ const char *COMPOSITION_name = "novelty";
 //---------------------------------------------------------------------
 // configuration
 
-// cost per sample is O(OVERLAP * COUNT / GRAINLENGTH)
+// without INDEX, cost per sample is O(OVERLAP * COUNT / GRAINLENGTH)
 // in bursts every GRAINLENGTH / OVERLAP samples
-// so block size GRAINLENGTH / OVERLAP is appropriate
+// so block size GRAINLENGTH / OVERLAP is appropriate;
+// with INDEX, the bursts grow much more slowly with INPUTDURATION
+// (once the index is built, in the background, after recording);
+// with CORRELATE, the bursts compare with every control frame,
+// about as quickly as without INDEX compares with every grain
 
 // channels must currently both be 2
 #define CONTROLCHANNELS 2 // magnitude and phase
@@ -62,16 +69,26 @@ const char *COMPOSITION_name = "novelty";
 #define CONTROLCUTOFF 100 // control data filter cutoff frequency
 #define GESTURELENGTH (GRAINLENGTH / SUBSAMPLING) // points per gesture
 #define JITTER 1 // set to 1 to enable pseudo-random jitter for variety
+#define INDEX 1 // set to 1 to search an index of gestures, 0 to compare with all
+#define RERANK 0 // 0 for exact index searches, else approximate, reranking this many
+#define CORRELATE 0 // set to 1 (with INDEX 0) to compare with all gestures by FFT cross-correlation
 
 #define AUDIOFRAMES (COUNT * GRAINLENGTH / OVERLAP)
 #define CONTROLFRAMES (COUNT * GRAINLENGTH / OVERLAP / SUBSAMPLING)
 
+// gestures searched: every control frame with jitter or CORRELATE, otherwise one per grain
+// (jitter picks one of the NEIGHBOURS nearest, and an audio offset within the frame)
+#define STRIDE ((JITTER || CORRELATE) ? 1 : GESTURELENGTH / OVERLAP)
+#define GESTURES ((CONTROLFRAMES - GESTURELENGTH - 1) / STRIDE + 1)
+#define NEIGHBOURS (JITTER ? 4 : 1)
+
 #define NONE (-1) // sentinel value for playbackOffset, for silence
 
 //---------------------------------------------------------------------
 // composition state
 
 enum COMPOSITIONMODE { RECORDING = 0, PLAYING = 1 };
+enum INDEXSTATE { INDEX_IDLE = 0, INDEX_SCHEDULED = 1, INDEX_RUNNING = 2, INDEX_CANCELLED = 3 };
 
 struct COMPOSITION
 {
@@ -97,8 +114,72 @@ struct COMPOSITION
 
 	int playbackFrame[OVERLAP]; // [0..GRAINLENGTH)
 	int playbackOffset[OVERLAP]; // [-1..AUDIOFRAMES-GRAINLENGTH]
+
+	RNG rng; // for jitter
+
+	GESTURE_INDEX index; // built from the database after recording
+	DISTANCE_PROFILE profile; // alternatively, prepared from the database after recording
+	float profileDistance[GESTURES]; // distance to every gesture
+	AuxiliaryTask indexTask; // builds the index or profile in the background
+	std::atomic<int> indexing; // INDEXSTATE of the task
+	std::atomic<bool> indexed; // set when the index or profile is ready
 };
 
+//---------------------------------------------------------------------
+// gesture index task
+
+void COMPOSITION_index(void *arg)
+{
+	COMPOSITION *C = (COMPOSITION *) arg;
+	// start, unless cleanup has cancelled it
+	int state = INDEX_SCHEDULED;
+	if (! C->indexing.compare_exchange_strong(state, INDEX_RUNNING, std::memory_order_acquire))
+	{
+		return;
+	}
+	if (INDEX)
+	{
+		gesture_index_build(&C->index, &C->control[0][0], C->controlWindow, GESTURES, STRIDE);
+	}
+	else
+	{
+		distance_profile_build(&C->profile, &C->control[0][0], C->controlWindow, GESTURES);
+	}
+	// publish the index to the audio thread
+	C->indexed.store(true, std::memory_order_release);
+	// allow cleanup to free it
+	C->indexing.store(INDEX_IDLE, std::memory_order_release);
+}
+
+//---------------------------------------------------------------------
+// nearest gestures by profile, returns the number found
+
+inline
+int
+COMPOSITION_nearest(struct COMPOSITION *C, int result[NEIGHBOURS], float distance[NEIGHBOURS])
+{
+	distance_profile_compute(&C->profile, &C->gesture[0][0], C->profileDistance);
+	// keep the nearest sorted by distance
+	int found = 0;
+	for (int g = 0; g < GESTURES; ++g)
+	{
+		float d = C->profileDistance[g];
+		if (found == NEIGHBOURS && ! (d < distance[found - 1]))
+		{
+			continue;
+		}
+		int i = found < NEIGHBOURS ? found++ : found - 1;
+		for (; i > 0 && d < distance[i - 1]; --i)
+		{
+			result[i] = result[i - 1];
+			distance[i] = distance[i - 1];
+		}
+		result[i] = g;
+		distance[i] = d;
+	}
+	return found;
+}
+
 //---------------------------------------------------------------------
 // called during setup
 
@@ -108,7 +189,13 @@ COMPOSITION_setup(BelaContext *context, struct COMPOSITION *C)
 {
 
 	// clear everything to 0
-	std::memset(C, 0, sizeof(*C));
+	// (the atomic flags are initialized explicitly)
+	std::memset((void *) C, 0, sizeof(*C));
+	C->indexing.store(INDEX_IDLE, std::memory_order_relaxed);
+	C->indexed.store(false, std::memory_order_relaxed);
+
+	// seed the jitter (the same every time, for reproducible renders)
+	rng_seed(&C->rng, 1);
 
 	// initialize raised cosine windows
 	for (int i = 0; i < GRAINLENGTH; ++i)
@@ -121,6 +208,25 @@ COMPOSITION_setup(BelaContext *context, struct COMPOSITION *C)
 		C->controlWindow[i] = 1 - cos(2 * M_PI * (i + 0.5) / GESTURELENGTH);
 	}
 
+	// allocate the gesture index or profile, built after recording
+	if (INDEX || CORRELATE)
+	{
+		if (INDEX && ! gesture_index_setup(&C->index, GESTURES, GESTURELENGTH, CONTROLCHANNELS))
+		{
+			rt_printf("error: could not allocate gesture index\n");
+			return false;
+		}
+		if (! INDEX && ! distance_profile_setup(&C->profile, GESTURES, GESTURELENGTH, CONTROLCHANNELS))
+		{
+			rt_printf("error: could not allocate gesture profile\n");
+			return false;
+		}
+		if (! (C->indexTask = Bela_createAuxiliaryTask(&COMPOSITION_index, 50, "gesture-index", C)))
+		{
+			return false;
+		}
+	}
+
 	// initialize database
 	for (int i = 0; i < OVERLAP; ++i)
 	{
@@ -233,6 +339,17 @@ COMPOSITION_render(BelaContext *context, struct COMPOSITION *C, int n,
 		{
 			C->mode = PLAYING;
 		}
+
+		// index the database in the background
+		// (until it is ready, playback compares with all gestures)
+		if ((INDEX || CORRELATE) && C->mode == PLAYING)
+		{
+			C->indexing.store(INDEX_SCHEDULED, std::memory_order_relaxed);
+			if (Bela_scheduleAuxiliaryTask(C->indexTask))
+			{
+				C->indexing.store(INDEX_IDLE, std::memory_order_relaxed);
+			}
+		}
 	}
 
 	// play back
@@ -274,31 +391,49 @@ COMPOSITION_render(BelaContext *context, struct COMPOSITION *C, int n,
 
 				// find the best match
 				int bestOffset = NONE;
-				float bestDistance = 1.0 / 0.0;
-				for (int i = 0; i < COUNT; ++i)
+				if ((INDEX || CORRELATE) && C->indexed.load(std::memory_order_acquire))
 				{
-					// add pseudo-random jitter to increase variety
-					int jitter = JITTER ? rand() % GRAINLENGTH : 0;
-					int audioOffset = (i * GRAINLENGTH + jitter) / OVERLAP;
-					if (audioOffset + GRAINLENGTH > AUDIOFRAMES) continue;
-					int gestureOffset = (i * GESTURELENGTH + jitter / SUBSAMPLING) / OVERLAP;
-					if (gestureOffset + GESTURELENGTH > CONTROLFRAMES) continue;
-					// compute a goodness-of-fit metric (lower is better)
-					// currently weights all control channels equally
-					float distance = 0;
-					for (int g = 0; g < GESTURELENGTH; ++g)
+					int result[NEIGHBOURS];
+					float distance[NEIGHBOURS];
+					int found = INDEX
+						? gesture_index_search(&C->index, &C->gesture[0][0], NEIGHBOURS, RERANK, result, distance)
+						: COMPOSITION_nearest(C, result, distance);
+					if (found > 0)
 					{
-						float window = C->controlWindow[g];
-						for (int c = 0; c < CONTROLCHANNELS; ++c)
-						{
-							float delta = C->gesture[g][c] - C->control[gestureOffset + g][c];
-							distance += window * delta * delta;
-						}
+						// pick one of the nearest, and jitter within the control frame, for variety
+						int gestureOffset = result[JITTER ? rng_below(&C->rng, found) : 0] * STRIDE;
+						int jitter = JITTER ? rng_below(&C->rng, SUBSAMPLING) : 0;
+						bestOffset = gestureOffset * SUBSAMPLING + jitter;
 					}
-					if (distance < bestDistance)
+				}
+				else
+				{
+					float bestDistance = 1.0 / 0.0;
+					for (int i = 0; i < COUNT; ++i)
 					{
-						bestDistance = distance;
-						bestOffset = audioOffset;
+						// add pseudo-random jitter to increase variety
+						int jitter = JITTER ? rng_below(&C->rng, GRAINLENGTH) : 0;
+						int audioOffset = (i * GRAINLENGTH + jitter) / OVERLAP;
+						if (audioOffset + GRAINLENGTH > AUDIOFRAMES) continue;
+						int gestureOffset = (i * GESTURELENGTH + jitter / SUBSAMPLING) / OVERLAP;
+						if (gestureOffset + GESTURELENGTH > CONTROLFRAMES) continue;
+						// compute a goodness-of-fit metric (lower is better)
+						// currently weights all control channels equally
+						float distance = 0;
+						for (int g = 0; g < GESTURELENGTH; ++g)
+						{
+							float window = C->controlWindow[g];
+							for (int c = 0; c < CONTROLCHANNELS; ++c)
+							{
+								float delta = C->gesture[g][c] - C->control[gestureOffset + g][c];
+								distance += window * delta * delta;
+							}
+						}
+						if (distance < bestDistance)
+						{
+							bestDistance = distance;
+							bestOffset = audioOffset;
+						}
 					}
 				}
 				C->playbackOffset[o] = bestOffset;
@@ -313,7 +448,18 @@ COMPOSITION_render(BelaContext *context, struct COMPOSITION *C, int n,
 inline
 void COMPOSITION_cleanup(BelaContext *context, struct COMPOSITION *C)
 {
-	// nothing to do
+	// cancel the index task if it has not started
+	// (once the audio has stopped, a queued task may never run),
+	// otherwise wait for it to finish with the database
+	int state = INDEX_SCHEDULED;
+	C->indexing.compare_exchange_strong(state, INDEX_CANCELLED, std::memory_order_acquire);
+	while (C->indexing.load(std::memory_order_acquire) == INDEX_RUNNING)
+	{
+		usleep(1000);
+	}
+	// free the gesture index and profile
+	gesture_index_cleanup(&C->index);
+	distance_profile_cleanup(&C->profile);
 }
 
 //---------------------------------------------------------------------
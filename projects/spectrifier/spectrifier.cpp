@@ -16,6 +16,7 @@ A collaboration between the Antennas & Electromagnetics Group and C4DM (Centre f
  */
 
 #include <libraries/REBUS/REBUS.h>
+#include <libraries/REBUS/wavetable.h>
 
 // read square wave table
 #include "square_table.h"
@@ -40,6 +41,8 @@ struct COMPOSITION
 	float pastStateInHP;  //gHP_b2
 	float prevStateOutHP;  //gHP_a1
 	float pastStateOutHP;  //gHP_a2
+	// band-limited square wave tables
+	WAVETABLE square;
 };
 
 float gMinPhase = 0.2;
@@ -79,55 +82,24 @@ bool COMPOSITION_setup(BelaContext *context, COMPOSITION *C)
 	C->gPhase = 0.0;
 	C->gFrequency = 440;
 
-	return true;
+	// unfold the quarter wave table into a whole cycle
+	float cycle[4 * squareTableLength];
+	for (int n = 0; n < squareTableLength; ++n)
+	{
+		cycle[n] = squareTable[n];
+		cycle[2 * squareTableLength - 1 - n] = squareTable[n];
+		cycle[2 * squareTableLength + n] = -squareTable[n];
+		cycle[4 * squareTableLength - 1 - n] = -squareTable[n];
+	}
+	// different tables for different frequency ranges so no aliasing
+	return wavetable_setup(&C->square, cycle, 4 * squareTableLength);
 }
 
 inline
-float square(float phase){
-	//  TODO:
-	// - use different tables for different frequency ranges so no aliasing
-
-	// stay in range
-phase /= (2.0 * M_PI);
-phase -= floorf(phase);
-phase *= (2.0 * M_PI);
-#if 0
-	while(phase >= 2.0 * M_PI)
-	            phase -= 2.0 * M_PI;
-	while(phase < 0)
-	            phase +=2.0*M_PI;
-#endif
-
-	//map phase to table length
-	float fracIndex=(phase/(2*M_PI) * squareTableLength);
-	int n=(int)fracIndex;
-	float x=fracIndex-n; // subtract to leave only the fraction value
-	float y0=squareTable[n];
-	float y1=squareTable[n+1];
-
-	if(n<=255){
-		y0 = squareTable[n];
-		y1 = squareTable[n+1];
-	}
-
-	if(256 < n && n < 512){
-		y0 = squareTable[255+(256-n)];
-		y1 = squareTable[(255+(256-n))+1];
-	}
-
-	if(512<=n && n<768){
-		y0 = -squareTable[n-512];
-		y1 = -squareTable[(n-512)-1];
-	}
-
-     if(768<=n && n<1024){
-    	y0 = -squareTable[255+(768-n)];
-    	y1 = -squareTable[(255+(768-n)) - 1];
-    }
-
-	// simplifies linear interpolation formula assuming x0=0, x1=1
-	float out=y0 + (y1-y0)*x;
-	return out;
+float square(const COMPOSITION *C, float phase){
+	// radians to 32bit phase, which wraps by itself
+	uint32_t p = (uint32_t) (int64_t) (phase * float(4294967296.0 / (2.0 * M_PI)));
+	return wavetable_read(&C->square, p, C->gFrequency);
 } 
 
 inline
@@ -216,7 +188,7 @@ void COMPOSITION_render(BelaContext* context, COMPOSITION *C, int n, float out[2
 		float FilterIn_A = C->gEmGain *  C->gPhase  + C->gEmGain * (C->gPhase+C->gEmPhase) + (C->gEmPhase*C->gEmGain)  + ((gain + phase)*2 - 1); // eliminate offset and remap from 0:1 to -1:1 to keep in range
 
         // pass to output as filterIn to a high pass filter // with square
-        float FilterIn_B = C->gEmGain *  square(C->gPhase)  + C->gEmGain * square(C->gPhase+C->gEmPhase) + (C->gEmPhase*C->gEmGain)  + ((gain + phase)*2 - 1); // eliminate offset and remap from 0:1 to -1:1 to keep in range
+        float FilterIn_B = C->gEmGain *  square(C, C->gPhase)  + C->gEmGain * square(C, C->gPhase+C->gEmPhase) + (C->gEmPhase*C->gEmGain)  + ((gain + phase)*2 - 1); // eliminate offset and remap from 0:1 to -1:1 to keep in range
 
 		float FilterIn =  FilterIn_A * (FilterIn_B /2);    
 
@@ -255,6 +227,7 @@ void COMPOSITION_render(BelaContext* context, COMPOSITION *C, int n, float out[2
 
 void COMPOSITION_cleanup(BelaContext *context, COMPOSITION *C)
 {
+	wavetable_cleanup(&C->square);
 
 }
 
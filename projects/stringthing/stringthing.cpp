@@ -23,6 +23,7 @@ Tested with block size 512, 60% CPU load.
 // dependencies
 
 #include <libraries/REBUS/REBUS.h>
+#include <libraries/REBUS/dsp_simd.h>
 
 //---------------------------------------------------------------------
 // added to audio recording filename
@@ -143,12 +144,14 @@ void COMPOSITION_render(BelaContext *context, struct COMPOSITION *C, int n, floa
 			C->lh = lv - C->lo;
 			C->rh = rv - C->ro;
 			// mix with previous with soft clipping
-			C->lb = std::tanh(((R)0.5) * C->lb + ((R)0.5) * wd * C->lh);
-			C->rb = std::tanh(((R)0.5) * C->rb + ((R)0.5) * wd * C->rh);
+			C->lb = fasttanh(((R)0.5) * C->lb + ((R)0.5) * wd * C->lh);
+			C->rb = fasttanh(((R)0.5) * C->rb + ((R)0.5) * wd * C->rh);
 			// write to string audio buffer
-			C->buf[j][0] = std::tanh(2 * C->lb);
-			C->buf[j][1] = std::tanh(2 * C->rb);
+			C->buf[j][0] = 2 * C->lb;
+			C->buf[j][1] = 2 * C->rb;
 		}
+		// soft clip the whole buffer (both channels) at once
+		fasttanh_block(&C->buf[0][0], &C->buf[0][0], 2 * 2 * C->N);
 	}
 
 	// use inputs from REBUS antenna
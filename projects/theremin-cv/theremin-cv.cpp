@@ -51,7 +51,7 @@ const char *COMPOSITION_name = "theremin-cv";
 struct COMPOSITION
 {
   int counter;
-  float gPhase;
+  PHASOR32 phase;
 };
 
 //---------------------------------------------------------------------
@@ -63,7 +63,7 @@ bool COMPOSITION_setup(BelaContext *context, COMPOSITION *C)
 {
 	// initialize state
 	C->counter = 0;
-	C->gPhase = 0;
+	C->phase.phase = 0;
 	return true;
 }
 
@@ -75,7 +75,7 @@ inline
 void COMPOSITION_render(BelaContext *context, COMPOSITION *C, int n,
   float audio_out[2], const float audio_in[2], const float _magnitude, const float _phase)
 {
-		float phaseReading = analogRead(context, n/2, 0);
+		float phaseReading = analogRead(context, REBUS_analogFrame(context, n), 0);
 		float frequency = map(phaseReading, gMinPhase, gMaxPhase, 100, 1000);
 		frequency = constrain(frequency, 100.0, 1000.0);
 		
@@ -83,16 +83,13 @@ void COMPOSITION_render(BelaContext *context, COMPOSITION *C, int n,
 		float cv = (frequency / 100.00)/2.0;
 
 		
-		float gainReading = analogRead(context, n/2, 4);
+		float gainReading = analogRead(context, REBUS_analogFrame(context, n), 4);
 		float amplitude = map(gainReading, gMinGain, gMaxGain, 0, 1);
 		amplitude = constrain(amplitude, 0, 1);
 		
 		float out;
 		
-		out = amplitude * sin(C->gPhase);
-		C->gPhase += 2.0 * M_PI * frequency / context->audioSampleRate;
-		if (C->gPhase >= M_PI)
-			C->gPhase -= 2.0 * M_PI;
+		out = amplitude * sinf(float(2.0 * M_PI) * phasor32(&C->phase, frequency));
 			
 		for (unsigned int channel = 0; channel < context->audioOutChannels; channel++){
 			if (channel < 2){
@@ -117,7 +114,7 @@ void COMPOSITION_render(BelaContext *context, COMPOSITION *C, int n,
 		
 		// cv = pin 0 out
 		if(context->analogOutChannels != 0){
-		analogWriteOnce(context, n/2, kCVOutPin, cv);
+		analogWriteOnce(context, REBUS_analogFrame(context, n), kCVOutPin, cv);
 		}
 
 		/*
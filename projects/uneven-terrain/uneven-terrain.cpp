@@ -38,11 +38,13 @@ struct COMPOSITION
 	PHASOR clock;
 
 	// resonant filters for pitched bass
-	BIQUAD bq[2];
+	// (double precision: at Q 100 the float poles detune audibly)
+	BIQUAD_COEFFS_DOUBLE bq[2];
+	BIQUAD_STATE_DOUBLE bqState[2];
 
 	// delay lines (with buffers) for stereo comb filter
-	DELAY del0; float del0buf[65536];
-	DELAY del1; float del1buf[65536];
+	MDELAY del0; float del0buf[65536];
+	MDELAY del1; float del1buf[65536];
 
 	// low-pass filters for smoothing control signals
 	LOP lo[2];
@@ -58,6 +60,9 @@ struct COMPOSITION
 
 	// high-pass (DC-blocking) filters for audio output
 	HIP dc[2];
+
+	// random number generator for noise
+	RNG rng;
 };
 
 //---------------------------------------------------------------------
@@ -66,27 +71,23 @@ struct COMPOSITION
 inline
 bool COMPOSITION_setup(BelaContext *context, struct COMPOSITION *C)
 {
-	// check that the actual float rate matches the dsp.h float rate
-	if (context->audioSampleRate != SR)
-	{
-		rt_printf("Sample rate mismatch: using %f, expected %f\n", (double) context->audioSampleRate, (double) SR);
-		// return false; // it'll sound at a different pitch and speed, should this be a hard failure?
-	}
-
 	// clear everything to 0
 	std::memset(C, 0, sizeof(*C));
 
+	// seed the noise (the same every time, for reproducible renders)
+	rng_seed(&C->rng, 1);
+
 	// resonant high pass filter (32 Hz, Q 12) for bass
 	highpass(&C->bq[0], 32, 12);
 
 	// resonant low pass filter (48 Hz, Q 100) for sub
 	lowpass(&C->bq[1], 48, 100);
 
-	// set the length of the delay lines
+	// set the length of the delay lines (as a mask, length - 1)
 	// should match the size of the arrays
 	// immediately following in the data structure
-	C->del0.length = 65536;
-	C->del1.length = 65536;
+	C->del0.mask = 65536 - 1;
+	C->del1.mask = 65536 - 1;
 
 	return true;
 }
@@ -130,8 +131,8 @@ void COMPOSITION_render(BelaContext *context, struct COMPOSITION *C, int n,
 	hat *= clamp(sinf(7 * float(2*M_PI) * m), 0, 1);
 	// make hi-hats as high-pass filtered noise in stereo
 	float hats[2] =
-		{ hip(&C->hat[0], noise() * hat, 4000)
-		, hip(&C->hat[1], noise() * hat, 4000)
+		{ hip(&C->hat[0], rng_uniform(&C->rng) * hat, 4000)
+		, hip(&C->hat[1], rng_uniform(&C->rng) * hat, 4000)
 		};
 
 	// make snare envelope every 2 beats (on the off-beat)
@@ -150,8 +151,8 @@ void COMPOSITION_render(BelaContext *context, struct COMPOSITION *C, int n,
     // modulate sample-and-hold frequency by magnitude
 	float snarePitch = mix(1000, 2000, 0.5 * (1.0 - cosf(6 * float(2*M_PI) * m)));
 	float snares[2] =
-		{ samphold(&C->snare[0], noise(), wrap(snarePitch * clock - 0.25)) * snare
-		, samphold(&C->snare[1], noise(), wrap(snarePitch * clock + 0.25)) * snare
+		{ samphold(&C->snare[0], rng_uniform(&C->rng), wrap(snarePitch * clock - 0.25)) * snare
+		, samphold(&C->snare[1], rng_uniform(&C->rng), wrap(snarePitch * clock + 0.25)) * snare
 		};
 
 	// make kick envelope every beat
@@ -166,18 +167,18 @@ void COMPOSITION_render(BelaContext *context, struct COMPOSITION *C, int n,
 	kick = sinf(16 * float(M_PI) * kick);
 
 	// bass is kick minus a resonant high pass filter of kick
-	float bass = kick - biquad(&C->bq[0], kick);
+	float bass = kick - biquad(&C->bq[0], &C->bqState[0], kick);
 
 	// sub is resonant low pass filter of kick
-	float sub = biquad(&C->bq[1], kick);
+	float sub = biquad(&C->bq[1], &C->bqState[1], kick);
 
 	// comb filter
 	// frequency of filter is modulated by both magnitude and phase
 	float fbhz = mix(64, 512, 0.5f * (1 - cosf(5 * float(2*M_PI) * (m + p))));
 	// read from delay lines
 	float fb0[2] =
-		{ delread1(&C->del0, 1000 / fbhz)
-		, delread1(&C->del1, 1000 / fbhz)
+		{ mdelread1(&C->del0, 1000 / fbhz)
+		, mdelread1(&C->del1, 1000 / fbhz)
 		};
 	// high pass filter to avoid DC offset
 	fb0[0] = hip(&C->fb[0], fb0[0], 100);
@@ -215,8 +216,8 @@ void COMPOSITION_render(BelaContext *context, struct COMPOSITION *C, int n,
 	), 1);
 
 	// write to the delay lines for the comb filter
-	delwrite(&C->del0, out[0] + snares[0]);
-	delwrite(&C->del1, out[1] + snares[1]);
+	mdelwrite(&C->del0, out[0] + snares[0]);
+	mdelwrite(&C->del1, out[1] + snares[1]);
 }
 
 //---------------------------------------------------------------------